@@ -0,0 +1,710 @@
+#include "bPlusTree.hpp"
+#include <iterator>
+#include <stdexcept>
+
+/**
+ * @brief Constructor for bPlusTree class, the tree starts as one empty leaf.
+ */
+bPlusTree::bPlusTree() : size(0) {
+  leafNode *leaf = new leafNode;
+  leaf->isLeaf = true;
+  leaf->count = 0;
+  leaf->next = nullptr;
+  root = leaf;
+}
+
+/**
+ * @brief Destructor for bPlusTree class.
+ *
+ * @details Frees the nodes of the tree. The ride records are released with
+ * the pool.
+ */
+bPlusTree::~bPlusTree() {
+  destroySubtree(root);
+}
+
+/**
+ * @brief Creates a record for the given ride from the pool of the tree.
+ *
+ * @param ride The ride held by the record.
+ * @return The new record, not yet in the tree.
+ */
+rbNode *bPlusTree::createNode(const rideInfo &ride) {
+  return pool.allocate(ride);
+}
+
+/**
+ * @brief Finds the child of an inner node whose subtree holds a ride number.
+ *
+ * @param inner The inner node.
+ * @param rideNumber The ride number.
+ * @return The index of the child, the number of separators not above the
+ * ride number.
+ */
+int bPlusTree::findChild(const innerNode *inner,
+                         rideNumberType rideNumber) {
+  return std::upper_bound(inner->keys, inner->keys + inner->count - 1,
+                          rideNumber) -
+         inner->keys;
+}
+
+/**
+ * @brief Returns the number of rides below a node.
+ *
+ * @param subtree The node.
+ * @return The number of rides in a leaf, or the sum of the sizes of the
+ * children of an inner node.
+ */
+int bPlusTree::subtreeSize(const node *subtree) {
+  if (subtree->isLeaf) {
+    return subtree->count;
+  }
+
+  const innerNode *inner = static_cast<const innerNode *>(subtree);
+  int total = 0;
+  for (int i = 0; i < inner->count; i++) {
+    total += inner->sizes[i];
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the leftmost leaf of the tree, which holds the smallest ride
+ * numbers.
+ *
+ * @return The first leaf.
+ */
+bPlusTree::leafNode *bPlusTree::firstLeaf() const {
+  node *current = root;
+  while (!current->isLeaf) {
+    current = static_cast<innerNode *>(current)->children[0];
+  }
+  return static_cast<leafNode *>(current);
+}
+
+/**
+ * @brief Descends from the root to the leaf responsible for a ride number.
+ *
+ * @param rideNumber The ride number.
+ * @param path Receives the inner nodes passed, from the root down.
+ * @param slots Receives the index of the child taken in each inner node.
+ * @param depth Set to the number of inner nodes passed.
+ * @return The leaf that holds or would hold the ride number.
+ */
+bPlusTree::leafNode *bPlusTree::descend(rideNumberType rideNumber,
+                                        innerNode **path, int *slots,
+                                        int &depth) const {
+  node *current = root;
+  depth = 0;
+
+  while (!current->isLeaf) {
+    innerNode *inner = static_cast<innerNode *>(current);
+    int index = findChild(inner, rideNumber);
+    path[depth] = inner;
+    slots[depth++] = index;
+    current = inner->children[index];
+  }
+  return static_cast<leafNode *>(current);
+}
+
+/**
+ * @brief Splits an overfull child of an inner node into two halves and adds
+ * the right half as a new child after it.
+ *
+ * @param parent The parent of the child, which may overflow in turn.
+ * @param index The index of the child in the parent.
+ */
+void bPlusTree::splitChild(innerNode *parent, int index) {
+  node *child = parent->children[index];
+  int half = child->count / 2;
+  rideNumberType separator;
+  node *sibling;
+
+  if (child->isLeaf) {
+    leafNode *left = static_cast<leafNode *>(child);
+    leafNode *right = new leafNode;
+    right->isLeaf = true;
+    right->count = left->count - half;
+    std::copy(left->keys + half, left->keys + left->count, right->keys);
+    std::copy(left->rides + half, left->rides + left->count, right->rides);
+    left->count = half;
+
+    // Link the new leaf into the list of leaves
+    right->next = left->next;
+    left->next = right;
+
+    separator = right->keys[0];
+    sibling = right;
+  } else {
+    // The separator between the halves moves up into the parent.
+    innerNode *left = static_cast<innerNode *>(child);
+    innerNode *right = new innerNode;
+    right->isLeaf = false;
+    right->count = left->count - half;
+    std::copy(left->keys + half, left->keys + left->count - 1, right->keys);
+    std::copy(left->children + half, left->children + left->count,
+              right->children);
+    std::copy(left->sizes + half, left->sizes + left->count, right->sizes);
+    separator = left->keys[half - 1];
+    left->count = half;
+    sibling = right;
+  }
+
+  // Make room for the new child and its separator
+  std::copy_backward(parent->keys + index, parent->keys + parent->count - 1,
+                     parent->keys + parent->count);
+  std::copy_backward(parent->children + index + 1,
+                     parent->children + parent->count,
+                     parent->children + parent->count + 1);
+  std::copy_backward(parent->sizes + index + 1, parent->sizes + parent->count,
+                     parent->sizes + parent->count + 1);
+
+  parent->keys[index] = separator;
+  parent->children[index + 1] = sibling;
+  parent->sizes[index + 1] = subtreeSize(sibling);
+  parent->sizes[index] -= parent->sizes[index + 1];
+  parent->count++;
+}
+
+/**
+ * @brief Inserts a ride into the tree.
+ * The ride goes into its leaf, and every node on the way back up that
+ * overflowed is split, growing a new root if the root splits. This takes
+ * O(log n) steps and moves at most one node's worth of entries per level.
+ *
+ * @param node The record of the ride to insert.
+ * @throw std::runtime_error If the ride number already exists in the tree.
+ **/
+void bPlusTree::insert(rbNode *node) {
+  if (node == nullptr) {
+    throw std::runtime_error("The node isn't a valid node\n");
+  }
+
+  innerNode *path[maxHeight];
+  int slots[maxHeight], depth;
+  leafNode *leaf = descend(node->rideNumber, path, slots, depth);
+
+  int index = std::lower_bound(leaf->keys, leaf->keys + leaf->count,
+                               node->rideNumber) -
+              leaf->keys;
+  if (index < leaf->count && leaf->keys[index] == node->rideNumber) {
+    throw std::runtime_error("Duplicate RideNumber\n");
+  }
+
+  std::copy_backward(leaf->keys + index, leaf->keys + leaf->count,
+                     leaf->keys + leaf->count + 1);
+  std::copy_backward(leaf->rides + index, leaf->rides + leaf->count,
+                     leaf->rides + leaf->count + 1);
+  leaf->keys[index] = node->rideNumber;
+  leaf->rides[index] = node;
+  leaf->count++;
+  size++;
+
+  // Walk back up, counting the new ride and splitting overfull nodes
+  for (int level = depth - 1; level >= 0; level--) {
+    path[level]->sizes[slots[level]]++;
+    if (path[level]->children[slots[level]]->count > capacity) {
+      splitChild(path[level], slots[level]);
+    }
+  }
+
+  if (root->count > capacity) {
+    innerNode *newRoot = new innerNode;
+    newRoot->isLeaf = false;
+    newRoot->count = 1;
+    newRoot->children[0] = root;
+    newRoot->sizes[0] = size;
+    root = newRoot;
+    splitChild(newRoot, 0);
+  }
+}
+
+/**
+ * @brief Refills an underfull child of an inner node.
+ * If the child and a neighbouring sibling fit into one node together, they
+ * are merged, which removes a child from the parent. Otherwise the child
+ * borrows the closest entry of the sibling, which has more than enough.
+ *
+ * @param parent The parent of the child, which may underflow in turn.
+ * @param index The index of the child in the parent.
+ */
+void bPlusTree::fixChild(innerNode *parent, int index) {
+  // Work on the child and its right sibling, or its left one for the last
+  // child, with left at position index in the parent.
+  if (index == parent->count - 1) {
+    index--;
+  }
+  node *left = parent->children[index];
+  node *right = parent->children[index + 1];
+  bool childIsLeft = left->count < minimum;
+
+  if (left->count + right->count <= capacity) {
+    if (left->isLeaf) {
+      leafNode *l = static_cast<leafNode *>(left);
+      leafNode *r = static_cast<leafNode *>(right);
+      std::copy(r->keys, r->keys + r->count, l->keys + l->count);
+      std::copy(r->rides, r->rides + r->count, l->rides + l->count);
+      l->next = r->next;
+      l->count += r->count;
+      delete r;
+    } else {
+      // The separator comes down between the keys of the two nodes.
+      innerNode *l = static_cast<innerNode *>(left);
+      innerNode *r = static_cast<innerNode *>(right);
+      l->keys[l->count - 1] = parent->keys[index];
+      std::copy(r->keys, r->keys + r->count - 1, l->keys + l->count);
+      std::copy(r->children, r->children + r->count, l->children + l->count);
+      std::copy(r->sizes, r->sizes + r->count, l->sizes + l->count);
+      l->count += r->count;
+      delete r;
+    }
+
+    // Remove the right node and its separator from the parent
+    parent->sizes[index] += parent->sizes[index + 1];
+    std::copy(parent->keys + index + 1, parent->keys + parent->count - 1,
+              parent->keys + index);
+    std::copy(parent->children + index + 2, parent->children + parent->count,
+              parent->children + index + 1);
+    std::copy(parent->sizes + index + 2, parent->sizes + parent->count,
+              parent->sizes + index + 1);
+    parent->count--;
+    return;
+  }
+
+  int moved;
+  if (left->isLeaf) {
+    leafNode *l = static_cast<leafNode *>(left);
+    leafNode *r = static_cast<leafNode *>(right);
+    if (childIsLeft) {
+      // The first ride of the right leaf moves to the end of the left one.
+      l->keys[l->count] = r->keys[0];
+      l->rides[l->count] = r->rides[0];
+      l->count++;
+      std::copy(r->keys + 1, r->keys + r->count, r->keys);
+      std::copy(r->rides + 1, r->rides + r->count, r->rides);
+      r->count--;
+    } else {
+      // The last ride of the left leaf moves to the front of the right one.
+      std::copy_backward(r->keys, r->keys + r->count,
+                         r->keys + r->count + 1);
+      std::copy_backward(r->rides, r->rides + r->count,
+                         r->rides + r->count + 1);
+      r->keys[0] = l->keys[l->count - 1];
+      r->rides[0] = l->rides[l->count - 1];
+      r->count++;
+      l->count--;
+    }
+    parent->keys[index] = r->keys[0];
+    moved = 1;
+  } else {
+    // A child moves between the nodes, and its separator rotates through
+    // the parent.
+    innerNode *l = static_cast<innerNode *>(left);
+    innerNode *r = static_cast<innerNode *>(right);
+    if (childIsLeft) {
+      l->keys[l->count - 1] = parent->keys[index];
+      l->children[l->count] = r->children[0];
+      l->sizes[l->count] = r->sizes[0];
+      l->count++;
+      moved = r->sizes[0];
+      parent->keys[index] = r->keys[0];
+      std::copy(r->keys + 1, r->keys + r->count - 1, r->keys);
+      std::copy(r->children + 1, r->children + r->count, r->children);
+      std::copy(r->sizes + 1, r->sizes + r->count, r->sizes);
+      r->count--;
+    } else {
+      std::copy_backward(r->keys, r->keys + r->count - 1,
+                         r->keys + r->count);
+      std::copy_backward(r->children, r->children + r->count,
+                         r->children + r->count + 1);
+      std::copy_backward(r->sizes, r->sizes + r->count,
+                         r->sizes + r->count + 1);
+      r->keys[0] = parent->keys[index];
+      r->children[0] = l->children[l->count - 1];
+      r->sizes[0] = l->sizes[l->count - 1];
+      r->count++;
+      moved = r->sizes[0];
+      parent->keys[index] = l->keys[l->count - 2];
+      l->count--;
+    }
+  }
+
+  // Rides moved from the right node to the left one count as negative.
+  if (!childIsLeft) {
+    moved = -moved;
+  }
+  parent->sizes[index] += moved;
+  parent->sizes[index + 1] -= moved;
+}
+
+/**
+ * @brief Deletes a ride from the tree and recycles its record.
+ * The ride is removed from its leaf, and every node on the way back up that
+ * became underfull borrows from or is merged with a sibling. A root with a
+ * single child is replaced by that child, so the tree shrinks again.
+ *
+ * @param node The record of the ride to delete.
+ * @throws std::runtime_error if the ride is not in the tree.
+ */
+void bPlusTree::deleteNode(rbNode *node) {
+  if (node == nullptr) {
+    throw std::runtime_error("The node isn't a valid node\n");
+  }
+
+  innerNode *path[maxHeight];
+  int slots[maxHeight], depth;
+  leafNode *leaf = descend(node->rideNumber, path, slots, depth);
+
+  int index = std::lower_bound(leaf->keys, leaf->keys + leaf->count,
+                               node->rideNumber) -
+              leaf->keys;
+  if (index == leaf->count || leaf->rides[index] != node) {
+    throw std::runtime_error("The node isn't a valid node\n");
+  }
+
+  std::copy(leaf->keys + index + 1, leaf->keys + leaf->count,
+            leaf->keys + index);
+  std::copy(leaf->rides + index + 1, leaf->rides + leaf->count,
+            leaf->rides + index);
+  leaf->count--;
+  size--;
+
+  // Walk back up, uncounting the ride and refilling underfull nodes
+  for (int level = depth - 1; level >= 0; level--) {
+    path[level]->sizes[slots[level]]--;
+    if (path[level]->children[slots[level]]->count < minimum) {
+      fixChild(path[level], slots[level]);
+    }
+  }
+
+  if (!root->isLeaf && root->count == 1) {
+    innerNode *oldRoot = static_cast<innerNode *>(root);
+    root = oldRoot->children[0];
+    delete oldRoot;
+  }
+
+  pool.release(node);
+}
+
+/**
+ * @brief Frees the nodes of a subtree. The depth is logarithmic in the
+ * number of rides, so the recursion stays shallow.
+ *
+ * @param subtree The root of the subtree.
+ */
+void bPlusTree::destroySubtree(node *subtree) {
+  if (subtree->isLeaf) {
+    delete static_cast<leafNode *>(subtree);
+    return;
+  }
+
+  innerNode *inner = static_cast<innerNode *>(subtree);
+  for (int i = 0; i < inner->count; i++) {
+    destroySubtree(inner->children[i]);
+  }
+  delete inner;
+}
+
+/**
+ * @brief Appends the rides of the tree to a vector in ride number order, by
+ * scanning the leaves.
+ *
+ * @param rides The vector receiving the rides.
+ */
+void bPlusTree::collectNodes(std::vector<rbNode *> &rides) const {
+  for (const leafNode *leaf = firstLeaf(); leaf != nullptr;
+       leaf = leaf->next) {
+    rides.insert(rides.end(), leaf->rides, leaf->rides + leaf->count);
+  }
+}
+
+/**
+ * @brief Replaces the tree by one built bottom-up from sorted rides.
+ * The rides are spread evenly over as few leaves as hold them at three
+ * quarters of their capacity, and every level of inner nodes is built the
+ * same way from the level below, which takes linear time. The spare room
+ * lets the next inserts land without splitting right away.
+ *
+ * @param rides All rides of the new tree, sorted by ride number.
+ */
+void bPlusTree::rebuild(const std::vector<rbNode *> &rides) {
+  const int fill = capacity * 3 / 4;
+
+  destroySubtree(root);
+  size = rides.size();
+
+  // The nodes of the level being built, with the smallest ride number and
+  // the number of rides below each
+  std::vector<node *> level;
+  std::vector<rideNumberType> firstKeys;
+  std::vector<int> sizes;
+
+  int leafCount = std::max<int>(1, (rides.size() + fill - 1) / fill);
+  leafNode *previous = nullptr;
+  std::size_t next = 0;
+
+  for (int i = 0; i < leafCount; i++) {
+    leafNode *leaf = new leafNode;
+    leaf->isLeaf = true;
+    leaf->count = (rides.size() - next) / (leafCount - i);
+    for (int j = 0; j < leaf->count; j++, next++) {
+      leaf->keys[j] = rides[next]->rideNumber;
+      leaf->rides[j] = rides[next];
+    }
+
+    leaf->next = nullptr;
+    if (previous != nullptr) {
+      previous->next = leaf;
+    }
+    previous = leaf;
+
+    level.push_back(leaf);
+    firstKeys.push_back(leaf->count > 0 ? leaf->keys[0] : 0);
+    sizes.push_back(leaf->count);
+  }
+
+  while (level.size() > 1) {
+    int innerCount = (level.size() + fill - 1) / fill;
+    std::vector<node *> upper;
+    std::vector<rideNumberType> upperKeys;
+    std::vector<int> upperSizes;
+    std::size_t child = 0;
+
+    for (int i = 0; i < innerCount; i++) {
+      innerNode *inner = new innerNode;
+      inner->isLeaf = false;
+      inner->count = (level.size() - child) / (innerCount - i);
+
+      int total = 0;
+      upperKeys.push_back(firstKeys[child]);
+      for (int j = 0; j < inner->count; j++, child++) {
+        if (j > 0) {
+          inner->keys[j - 1] = firstKeys[child];
+        }
+        inner->children[j] = level[child];
+        inner->sizes[j] = sizes[child];
+        total += sizes[child];
+      }
+
+      upper.push_back(inner);
+      upperSizes.push_back(total);
+    }
+
+    level.swap(upper);
+    firstKeys.swap(upperKeys);
+    sizes.swap(upperSizes);
+  }
+
+  root = level[0];
+}
+
+/**
+ * @brief Inserts a batch of rides by rebuilding the tree bottom-up.
+ * The batch is sorted and merged with the rides already in the tree, then
+ * the whole tree is rebuilt. This takes O(n + m log m) for n rides in the
+ * tree and m new rides, or O(n + m) if the batch is already sorted.
+ *
+ * @param nodes The records to be inserted, which are sorted in place.
+ * @throw std::runtime_error If a ride number appears twice in the batch or
+ * already exists in the tree. The tree is left unchanged.
+ **/
+void bPlusTree::bulkInsert(std::vector<rbNode *> &nodes) {
+  if (nodes.empty()) {
+    return;
+  }
+
+  auto byRideNumber = [](rbNode *a, rbNode *b) {
+    return a->rideNumber < b->rideNumber;
+  };
+  if (!std::is_sorted(nodes.begin(), nodes.end(), byRideNumber)) {
+    std::sort(nodes.begin(), nodes.end(), byRideNumber);
+  }
+
+  std::vector<rbNode *> existing;
+  existing.reserve(size);
+  collectNodes(existing);
+
+  // Merge the batch with the rides of the tree, checking for duplicates
+  // before anything is rebuilt.
+  std::vector<rbNode *> merged;
+  merged.reserve(existing.size() + nodes.size());
+  std::merge(existing.begin(), existing.end(), nodes.begin(), nodes.end(),
+             std::back_inserter(merged), byRideNumber);
+
+  for (std::size_t i = 1; i < merged.size(); i++) {
+    if (merged[i - 1]->rideNumber == merged[i]->rideNumber) {
+      throw std::runtime_error("Duplicate RideNumber\n");
+    }
+  }
+
+  rebuild(merged);
+}
+
+/**
+ * @brief Returns a record that is not in the tree to the pool.
+ *
+ * @param node The record to be recycled.
+ **/
+void bPlusTree::destroyNode(rbNode *node) {
+  pool.release(node);
+}
+
+/**
+ * @brief Deletes a batch of rides from the tree and recycles their records.
+ * A batch that is large compared to the tree is removed by filtering the
+ * rides in order and rebuilding the tree. Smaller batches are deleted one
+ * ride at a time.
+ *
+ * @param nodes The records to be deleted, which are sorted in place.
+ **/
+void bPlusTree::deleteNodes(std::vector<rbNode *> &nodes) {
+  if (8 * nodes.size() < size) {
+    for (rbNode *node : nodes) {
+      deleteNode(node);
+    }
+    return;
+  }
+
+  std::sort(nodes.begin(), nodes.end(), [](rbNode *a, rbNode *b) {
+    return a->rideNumber < b->rideNumber;
+  });
+
+  std::vector<rbNode *> existing;
+  existing.reserve(size);
+  collectNodes(existing);
+
+  std::vector<rbNode *> kept;
+  kept.reserve(existing.size() - nodes.size());
+
+  std::size_t next = 0;
+  for (rbNode *node : existing) {
+    if (next < nodes.size() && nodes[next] == node) {
+      next++;
+    } else {
+      kept.push_back(node);
+    }
+  }
+
+  rebuild(kept);
+
+  for (rbNode *node : nodes) {
+    pool.release(node);
+  }
+}
+
+/**
+ * @brief Search for a ride with a given ride number.
+ *
+ * @param rideNumber The ride number to search for.
+ * @return Pointer to the record of the ride, or nullptr if it is not found.
+ */
+rbNode *bPlusTree::search(rideNumberType rideNumber) {
+  const node *current = root;
+  while (!current->isLeaf) {
+    const innerNode *inner = static_cast<const innerNode *>(current);
+    current = inner->children[findChild(inner, rideNumber)];
+  }
+
+  const leafNode *leaf = static_cast<const leafNode *>(current);
+  int index =
+      std::lower_bound(leaf->keys, leaf->keys + leaf->count, rideNumber) -
+      leaf->keys;
+  if (index < leaf->count && leaf->keys[index] == rideNumber) {
+    return leaf->rides[index];
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Returns the number of rides in the tree.
+ *
+ * @return The number of rides.
+ */
+int bPlusTree::getSize() const {
+  return size;
+}
+
+/**
+ * @brief Counts the rides with a ride number below a bound.
+ * Descends from the root towards the bound and adds up the sizes of the
+ * children left of the path, which takes O(log n) steps.
+ *
+ * @param rideNumber The bound.
+ * @param inclusive Whether a ride equal to the bound is counted.
+ * @return The number of rides below the bound.
+ */
+int bPlusTree::countBelow(rideNumberType rideNumber, bool inclusive) const {
+  const node *current = root;
+  int count = 0;
+
+  while (!current->isLeaf) {
+    const innerNode *inner = static_cast<const innerNode *>(current);
+    int index = findChild(inner, rideNumber);
+    for (int i = 0; i < index; i++) {
+      count += inner->sizes[i];
+    }
+    current = inner->children[index];
+  }
+
+  const leafNode *leaf = static_cast<const leafNode *>(current);
+  if (inclusive) {
+    count += std::upper_bound(leaf->keys, leaf->keys + leaf->count,
+                              rideNumber) -
+             leaf->keys;
+  } else {
+    count += std::lower_bound(leaf->keys, leaf->keys + leaf->count,
+                              rideNumber) -
+             leaf->keys;
+  }
+  return count;
+}
+
+/**
+ * @brief Counts the rides with ride numbers within a given range.
+ *
+ * @param rideNumber1 The lower bound of the range of ride numbers.
+ * @param rideNumber2 The upper bound of the range of ride numbers.
+ * @return The number of rides in the range, 0 for an empty range.
+ */
+int bPlusTree::countInRange(rideNumberType rideNumber1,
+                            rideNumberType rideNumber2) const {
+  if (rideNumber1 > rideNumber2) {
+    return 0;
+  }
+  return countBelow(rideNumber2, true) - countBelow(rideNumber1, false);
+}
+
+/**
+ * @brief Finds the ride with the k-th smallest ride number.
+ *
+ * @param k The position of the ride in ride number order, counting from 1.
+ * @return Pointer to the record of the ride, or nullptr if k is out of range.
+ */
+rbNode *bPlusTree::select(int k) const {
+  if (k < 1 || k > size) {
+    return nullptr;
+  }
+
+  const node *current = root;
+  while (!current->isLeaf) {
+    const innerNode *inner = static_cast<const innerNode *>(current);
+    int index = 0;
+    while (k > inner->sizes[index]) {
+      k -= inner->sizes[index++];
+    }
+    current = inner->children[index];
+  }
+
+  return static_cast<const leafNode *>(current)->rides[k - 1];
+}
+
+/**
+ * @brief Returns the number of rides with a ride number not above the given
+ * one. For a ride in the tree, this is its position in ride number order.
+ *
+ * @param rideNumber The ride number.
+ * @return The rank of the ride number.
+ */
+int bPlusTree::rank(rideNumberType rideNumber) const {
+  return countBelow(rideNumber, true);
+}
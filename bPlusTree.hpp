@@ -0,0 +1,193 @@
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include "rbNode.hpp"
+#include "rbNodePool.hpp"
+#include <algorithm>
+#include <vector>
+
+// An ordered index of rides by ride number with the same interface as rbTree.
+// It is a B+-tree with wide nodes: a node holds up to 32 ride numbers in one
+// contiguous array, so a search reads a few cache lines per level
+// instead of one scattered node per comparison, and the tree is only a few
+// levels deep even for millions of rides. The rides themselves stay in
+// rbNode records, which the heaps link to, but their tree links are unused.
+//
+// All rides are kept in the leaves, which are linked in ride number order, so
+// a range scan descends once and then walks the leaves sequentially. Inner
+// nodes store the number of rides below each child, which keeps select, rank
+// and counting ranges at O(log n) like the subtree sizes of rbTree.
+class bPlusTree {
+private:
+  // Largest number of rides in a leaf and of children of an inner node, and
+  // the smallest number a node other than the root may shrink to before it
+  // borrows from or is merged with a sibling.
+  static constexpr int capacity = 32;
+  static constexpr int minimum = capacity / 4;
+
+  // Bound on the height of the tree, far above log_8 of 2^31 rides.
+  static constexpr int maxHeight = 32;
+
+  // Header shared by both kinds of nodes. count is the number of rides in a
+  // leaf and the number of children of an inner node.
+  struct node {
+    bool isLeaf;
+    int count;
+  };
+
+  // A leaf holds rides sorted by ride number. The arrays have one spare slot,
+  // so a full leaf can take an insert before it is split.
+  struct alignas(64) leafNode : node {
+    rideNumberType keys[capacity + 1];
+    rbNode *rides[capacity + 1];
+    leafNode *next;
+  };
+
+  // An inner node with count children. keys[i] separates children i and
+  // i + 1: every ride below child i has a smaller ride number, and every ride
+  // below child i + 1 one not smaller. sizes[i] is the number of rides below
+  // child i. The arrays have one spare slot for splitting like the leaves.
+  struct alignas(64) innerNode : node {
+    rideNumberType keys[capacity];
+    node *children[capacity + 1];
+    int sizes[capacity + 1];
+  };
+
+  node *root;
+  int size; // Number of rides in the tree.
+
+  // Allocator for the ride records of this tree.
+  rbNodePool pool;
+
+  // Returns the index of the child of an inner node to descend into for the
+  // given ride number.
+  static int findChild(const innerNode *inner, rideNumberType rideNumber);
+
+  // Returns the number of rides below a node.
+  static int subtreeSize(const node *subtree);
+
+  // Returns the leftmost leaf of the tree.
+  leafNode *firstLeaf() const;
+
+  // Descends to the leaf that holds or would hold the given ride number,
+  // recording the inner nodes passed and the child taken in each. Returns the
+  // leaf and sets depth to the number of inner nodes recorded.
+  leafNode *descend(rideNumberType rideNumber, innerNode **path,
+                    int *slots, int &depth) const;
+
+  // Splits the overfull child at the given index of an inner node in two.
+  void splitChild(innerNode *parent, int index);
+
+  // Refills the underfull child at the given index of an inner node from a
+  // sibling, or merges it with one.
+  void fixChild(innerNode *parent, int index);
+
+  // Frees every node of a subtree, but not the rides.
+  void destroySubtree(node *subtree);
+
+  // Appends the rides of the tree to the vector in ride number order.
+  void collectNodes(std::vector<rbNode *> &rides) const;
+
+  // Replaces the tree by one built bottom-up from the given sorted rides.
+  void rebuild(const std::vector<rbNode *> &rides);
+
+public:
+  // The records of the rides, which are the nodes of the red black tree.
+  using nodeType = rbNode;
+
+  // Constructor and destructor for a new tree.
+  bPlusTree();
+  ~bPlusTree();
+
+  bPlusTree(const bPlusTree &) = delete;
+  bPlusTree &operator=(const bPlusTree &) = delete;
+
+  // Creates a record for the given ride. The record belongs to this tree and
+  // is recycled when it is deleted.
+  rbNode *createNode(const rideInfo &ride);
+
+  // Inserts the given ride into the tree.
+  // Throws std::runtime_error if the ride number is already in the tree.
+  void insert(rbNode *node);
+
+  // Inserts all given rides at once by rebuilding the tree in linear time.
+  // Throws std::runtime_error and leaves the tree unchanged if a ride number
+  // is duplicated.
+  void bulkInsert(std::vector<rbNode *> &nodes);
+
+  // Returns a record that was never inserted, or failed to insert, to the
+  // pool.
+  void destroyNode(rbNode *node);
+
+  // Deletes the given ride from the tree and recycles its record.
+  // Throws std::runtime_error if the ride is not in the tree.
+  void deleteNode(rbNode *node);
+
+  // Deletes all given rides from the tree and recycles their records.
+  void deleteNodes(std::vector<rbNode *> &nodes);
+
+  // Searches for the ride with the given ride number in the tree.
+  rbNode *search(rideNumberType rideNumber);
+
+  // Returns the number of rides in the tree.
+  int getSize() const;
+
+  // Returns the number of rides with a ride number below the given one, or
+  // not above it if inclusive is set.
+  int countBelow(rideNumberType rideNumber, bool inclusive) const;
+
+  // Returns the number of rides with ride numbers in the given range.
+  int countInRange(rideNumberType rideNumber1,
+                   rideNumberType rideNumber2) const;
+
+  // Returns the ride with the k-th smallest ride number, counting from 1, or
+  // nullptr if the tree has fewer than k rides.
+  rbNode *select(int k) const;
+
+  // Returns the number of rides with a ride number not above the given one,
+  // which is the position of the ride in ride number order if it exists.
+  int rank(rideNumberType rideNumber) const;
+
+  // Calls visit with a const reference to every ride whose ride number lies
+  // in the given range, in ride number order.
+  template <typename Visitor>
+  void forEachInRange(rideNumberType rideNumber1, rideNumberType rideNumber2,
+                      Visitor visit) const;
+};
+
+/**
+ * @brief Visits all rides within a given range.
+ * The walk descends once to the first ride of the range and then scans the
+ * linked leaves, which reads the ride numbers of the range sequentially. It
+ * takes O(log n + k) steps for k rides in the range and allocates nothing.
+ *
+ * @param rideNumber1 The lower bound of the range of ride numbers.
+ * @param rideNumber2 The upper bound of the range of ride numbers.
+ * @param visit Function called with a const reference to every ride found.
+ */
+template <typename Visitor>
+void bPlusTree::forEachInRange(rideNumberType rideNumber1,
+                               rideNumberType rideNumber2,
+                               Visitor visit) const {
+  const node *current = root;
+  while (!current->isLeaf) {
+    const innerNode *inner = static_cast<const innerNode *>(current);
+    current = inner->children[findChild(inner, rideNumber1)];
+  }
+
+  const leafNode *leaf = static_cast<const leafNode *>(current);
+  int index =
+      std::lower_bound(leaf->keys, leaf->keys + leaf->count, rideNumber1) -
+      leaf->keys;
+
+  for (; leaf != nullptr; leaf = leaf->next, index = 0) {
+    for (; index < leaf->count; index++) {
+      if (leaf->keys[index] > rideNumber2) {
+        return;
+      }
+      visit(*leaf->rides[index]);
+    }
+  }
+}
+
+#endif // BPLUSTREE_H
@@ -0,0 +1,673 @@
+#include "bPlusTree.hpp"
+#include "ingestEngine.hpp"
+#include "minHeap.hpp"
+#include "packedHeap.hpp"
+#include "pairingHeap.hpp"
+#include "rbTree.hpp"
+#include "rideLookup.hpp"
+#include "shardedDispatcher.hpp"
+#include "workStealingPool.hpp"
+#include "writeAheadLog.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <type_traits>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// Number of calls to the global operator new, to report allocations per op.
+static std::atomic<long long> allocationCount{0};
+
+void *operator new(std::size_t size) {
+  allocationCount++;
+  if (void *memory = std::malloc(size ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  allocationCount++;
+  std::size_t align = static_cast<std::size_t>(alignment);
+  if (void *memory = std::aligned_alloc(align, (size + align - 1) / align *
+                                                   align)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+namespace {
+
+// Largest number of measured operations per workload.
+const long long maxOps = 1000000;
+
+// Number of ride numbers covered by a range Print, about 100 rides.
+const int rangeWidth = 200;
+
+// Largest number of measured rounds of the logged workloads, which may sync
+// the log after every command, and the log they write in the current
+// directory, so that it lives on a real disk rather than a tmpfs.
+const long long maxLoggedRounds = 20000;
+const char *const logFileName = "gatorBench.log";
+
+// A ride queue made of an index, the red black tree or the B+-tree, and a
+// heap, driven the same way as the commands in main.cpp. If Indexed is set,
+// rides are found by ride number through a rideLookup kept next to the
+// tree, as with --lookup.
+template <typename Heap, typename Tree = rbTree, bool Indexed = false>
+struct rideQueue {
+  using nodeType = typename Tree::nodeType;
+
+  Tree tree;
+  Heap heap;
+  rideLookup lookup;
+  std::mt19937 rng{42};
+  // Ride numbers that are not in use, and those in use in random order.
+  std::vector<rideNumberType> freeNumbers;
+  std::vector<rideNumberType> usedNumbers;
+
+  // Ride numbers are drawn from 2 * rides consecutive numbers, so half of
+  // them are in use.
+  explicit rideQueue(long long rides) {
+    for (int i = 0; i < 2 * rides; i++) {
+      freeNumbers.push_back(i);
+    }
+    std::shuffle(freeNumbers.begin(), freeNumbers.end(), rng);
+  }
+
+  void insert() {
+    rideNumberType rideNumber = freeNumbers.back();
+    freeNumbers.pop_back();
+    usedNumbers.push_back(rideNumber);
+
+    nodeType *ride = tree.createNode(
+        {rideNumber, int(rng() % 100000), int(rng() % 100000 + 1)});
+    tree.insert(ride);
+    if constexpr (Indexed) {
+      lookup.insert(ride);
+    }
+    heap.insert(ride);
+  }
+
+  nodeType *find(rideNumberType rideNumber) {
+    if constexpr (Indexed) {
+      return lookup.find(rideNumber);
+    } else {
+      return tree.search(rideNumber);
+    }
+  }
+
+  void deleteRide(nodeType *ride) {
+    if constexpr (Indexed) {
+      lookup.erase(ride->rideNumber);
+    }
+    tree.deleteNode(ride);
+  }
+
+  void getNextRide() {
+    nodeType *ride = heap.removeMin();
+    freeNumbers.push_back(ride->rideNumber);
+    deleteRide(ride);
+  }
+
+  // Picks a random ride in use and removes its number from usedNumbers.
+  rideNumberType takeUsedNumber() {
+    std::size_t index = rng() % usedNumbers.size();
+    rideNumberType rideNumber = usedNumbers[index];
+    usedNumbers[index] = usedNumbers.back();
+    usedNumbers.pop_back();
+    return rideNumber;
+  }
+
+  void cancelRide() {
+    rideNumberType rideNumber = takeUsedNumber();
+    nodeType *ride = find(rideNumber);
+    if (ride != nullptr) {
+      int idx = ride->getHeapHandle();
+      deleteRide(ride);
+      heap.remove(idx);
+      freeNumbers.push_back(rideNumber);
+    }
+  }
+
+  // Stretches or shortens a trip within the limits of UpdateTrip, so the
+  // ride is never declined.
+  void updateTrip() {
+    nodeType *ride = find(usedNumbers[rng() % usedNumbers.size()]);
+    if (ride != nullptr) {
+      int newTripDuration = rng() % (2 * ride->tripDuration) + 1;
+      ride->rideCost += newTripDuration <= ride->tripDuration ? 0 : 10;
+      ride->tripDuration = newTripDuration;
+      heap.update(ride);
+    }
+  }
+
+  // Looks up a ride number that is in use half of the time.
+  long long printRide(long long rides) {
+    nodeType *ride = find(rng() % (2 * rides));
+    return ride != nullptr ? ride->tripDuration : 0;
+  }
+
+  long long printRange(long long rides) {
+    rideNumberType rideNumber1 = rng() % (2 * rides);
+    long long sum = 0;
+    tree.forEachInRange(
+        rideNumber1, rideNumber1 + rangeWidth,
+        [&](const nodeType &ride) { sum += ride.tripDuration; });
+    return sum;
+  }
+};
+
+// Result of one workload.
+struct benchResult {
+  long long ops;
+  double seconds;
+  long long allocations;
+};
+
+/**
+ * @brief Times a number of operations of one workload.
+ *
+ * @details The operation is a template parameter, so each workload gets its
+ * own loop with the operation inlined and nothing but the operation is
+ * measured.
+ *
+ * @param ops Number of operations.
+ * @param step The operation, returning a value added to a checksum.
+ * @return The measurements of the operations.
+ */
+template <typename Step> benchResult timeOps(long long ops, Step step) {
+  long long checksum = 0;
+  long long allocationsBefore = allocationCount;
+  auto start = std::chrono::steady_clock::now();
+
+  for (long long i = 0; i < ops; i++) {
+    checksum += step();
+  }
+
+  auto stop = std::chrono::steady_clock::now();
+
+  // Keep the print results alive so the searches are not optimized away.
+  if (checksum < 0) {
+    std::printf("%lld\n", checksum);
+  }
+
+  return {ops, std::chrono::duration<double>(stop - start).count(),
+          allocationCount - allocationsBefore};
+}
+
+/**
+ * @brief Runs one workload on a queue holding the given number of rides.
+ *
+ * @details The workload name is resolved before the clock starts.
+ *
+ * @param workload Name of the workload.
+ * @param rides Number of active rides.
+ * @return The measurements of the workload.
+ */
+template <typename Heap, typename Tree, bool Indexed>
+benchResult runWorkload(const std::string &workload, long long rides) {
+  rideQueue<Heap, Tree, Indexed> queue(rides);
+  long long ops = std::min(rides, maxOps);
+
+  // Pure inserts start from an empty queue, every other workload from a full
+  // one.
+  if (workload == "insert") {
+    return timeOps(rides, [&]() {
+      queue.insert();
+      return 0LL;
+    });
+  }
+
+  for (long long i = 0; i < rides; i++) {
+    queue.insert();
+  }
+
+  if (workload == "dispatch") {
+    return timeOps(ops, [&]() {
+      queue.insert();
+      queue.getNextRide();
+      return 0LL;
+    });
+  } else if (workload == "cancel") {
+    return timeOps(ops, [&]() {
+      queue.cancelRide();
+      queue.insert();
+      return 0LL;
+    });
+  } else if (workload == "update") {
+    return timeOps(ops, [&]() {
+      queue.updateTrip();
+      return 0LL;
+    });
+  } else if (workload == "print") {
+    return timeOps(ops, [&]() { return queue.printRide(rides); });
+  } else {
+    return timeOps(ops, [&]() { return queue.printRange(rides); });
+  }
+}
+
+// Number of shards of the dispatcher in the threaded workload.
+const int benchShards = 64;
+
+/**
+ * @brief Runs point operations on a sharded dispatcher from several threads.
+ *
+ * @details Thread t owns the ride numbers congruent to t modulo the number of
+ * threads and keeps half of them in use. Each round cancels a ride, inserts a
+ * free one, updates a trip and looks up a ride, so all four operations lock a
+ * single shard.
+ *
+ * @param threads Number of threads.
+ * @param rides Number of active rides over all threads.
+ * @return The measurements of the workload, counting every operation.
+ */
+template <typename Heap>
+benchResult runSharded(int threads, long long rides) {
+  shardedDispatcher<Heap> dispatcher(benchShards);
+  long long rounds = std::min(rides, maxOps) / threads;
+  std::atomic<long long> checksum{0};
+
+  auto worker = [&](int thread, bool measured) {
+    std::mt19937 rng(42 + thread);
+    std::vector<int> usedNumbers, freeNumbers;
+    for (long long i = thread; i < 2 * rides; i += threads) {
+      (usedNumbers.size() <= freeNumbers.size() ? usedNumbers : freeNumbers)
+          .push_back(i);
+    }
+
+    if (!measured) {
+      for (rideNumberType rideNumber : usedNumbers) {
+        dispatcher.insert(rideNumber, rng() % 100000, rng() % 100000 + 1);
+      }
+      return;
+    }
+
+    long long sum = 0;
+    rideInfo ride;
+    for (long long i = 0; i < rounds; i++) {
+      std::size_t used = rng() % usedNumbers.size();
+      std::size_t free = rng() % freeNumbers.size();
+      std::swap(usedNumbers[used], freeNumbers[free]);
+
+      dispatcher.cancelRide(freeNumbers[free]);
+      dispatcher.insert(usedNumbers[used], rng() % 100000, rng() % 100000 + 1);
+
+      rideNumberType rideNumber = usedNumbers[rng() % usedNumbers.size()];
+      dispatcher.updateTrip(rideNumber, rng() % 100000 + 1);
+      if (dispatcher.find(rideNumber, ride)) {
+        sum += ride.tripDuration;
+      }
+    }
+    checksum += sum;
+  };
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++) {
+    pool.emplace_back(worker, t, false);
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+  pool.clear();
+
+  long long allocationsBefore = allocationCount;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int t = 0; t < threads; t++) {
+    pool.emplace_back(worker, t, true);
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+
+  auto stop = std::chrono::steady_clock::now();
+
+  if (checksum < 0) {
+    std::printf("%lld\n", checksum.load());
+  }
+
+  long long ops = 4 * rounds * threads;
+  return {ops, std::chrono::duration<double>(stop - start).count(),
+          allocationCount - allocationsBefore};
+}
+
+// Number of zones in the multi-city workload, and the number of rounds a zone
+// runs before it goes back to the pool.
+const int benchZones = 64;
+const long long zoneSlice = 1024;
+
+/**
+ * @brief Runs independent zones, each a ride queue of its own, on a
+ * work-stealing pool, like gatorTaxi does with --zone.
+ *
+ * @details The rides are split evenly among the zones. Each round of a zone
+ * inserts a ride, dispatches one and updates a trip, and a zone gives its
+ * worker back after every slice of rounds.
+ *
+ * @param threads Number of worker threads.
+ * @param rides Number of active rides over all zones.
+ * @return The measurements of the workload, counting every operation.
+ */
+template <typename Heap>
+benchResult runZones(int threads, long long rides) {
+  long long zoneRides = std::max(rides / benchZones, 1LL);
+  long long rounds = std::max(std::min(rides, maxOps) / benchZones, 1LL);
+
+  std::vector<std::unique_ptr<rideQueue<Heap>>> zones;
+  for (int i = 0; i < benchZones; i++) {
+    zones.emplace_back(new rideQueue<Heap>(zoneRides));
+    for (long long j = 0; j < zoneRides; j++) {
+      zones.back()->insert();
+    }
+  }
+
+  long long allocationsBefore = allocationCount;
+  auto start = std::chrono::steady_clock::now();
+
+  {
+    workStealingPool pool(threads);
+    std::vector<long long> done(benchZones, 0);
+
+    // Runs the next slice of a zone and submits the rest to the same worker.
+    std::function<void(int, int)> runSlice = [&](int zone, int worker) {
+      long long stop = std::min(done[zone] + zoneSlice, rounds);
+      for (; done[zone] < stop; done[zone]++) {
+        zones[zone]->insert();
+        zones[zone]->getNextRide();
+        zones[zone]->updateTrip();
+      }
+      if (done[zone] < rounds) {
+        pool.submit([&, zone](int next) { runSlice(zone, next); }, worker);
+      }
+    };
+
+    for (int zone = 0; zone < benchZones; zone++) {
+      pool.submit([&, zone](int worker) { runSlice(zone, worker); });
+    }
+    pool.wait();
+  }
+
+  auto stop = std::chrono::steady_clock::now();
+
+  long long ops = 3 * rounds * benchZones;
+  return {ops, std::chrono::duration<double>(stop - start).count(),
+          allocationCount - allocationsBefore};
+}
+
+// Number of commands each producer keeps in flight in the ingest workload.
+const int producerWindow = 16;
+
+/**
+ * @brief Runs point operations on an ingest engine from several producer
+ * threads.
+ *
+ * @details The rides are split among the producers like in runSharded, and
+ * each round submits a cancel, an insert, an update and a lookup. Every
+ * producer keeps producerWindow commands in flight and waits for the oldest
+ * one before reusing its slot.
+ *
+ * @param producers Number of producer threads.
+ * @param rides Number of active rides over all producers.
+ * @return The measurements of the workload, counting every command.
+ */
+template <typename Heap>
+benchResult runIngest(int producers, long long rides) {
+  ingestEngine<Heap> engine(1024);
+  long long rounds = std::min(rides, maxOps) / producers;
+  std::atomic<long long> checksum{0};
+
+  auto producer = [&](int thread, bool measured) {
+    std::mt19937 rng(42 + thread);
+    std::vector<int> usedNumbers, freeNumbers;
+    for (long long i = thread; i < 2 * rides; i += producers) {
+      (usedNumbers.size() <= freeNumbers.size() ? usedNumbers : freeNumbers)
+          .push_back(i);
+    }
+
+    completionSlot slots[producerWindow];
+    long long submitted = 0, sum = 0;
+
+    auto submit = [&](const command &cmd) {
+      completionSlot &slot = slots[submitted++ % producerWindow];
+      if (submitted > producerWindow) {
+        sum += slot.wait().rides.size();
+      }
+      engine.submit(cmd, slot);
+    };
+
+    if (!measured) {
+      for (rideNumberType rideNumber : usedNumbers) {
+        submit({commandType::INSERT,
+                {rideNumber, int(rng() % 100000), int(rng() % 100000 + 1)}});
+      }
+    } else {
+      for (long long i = 0; i < rounds; i++) {
+        std::size_t used = rng() % usedNumbers.size();
+        std::size_t free = rng() % freeNumbers.size();
+        std::swap(usedNumbers[used], freeNumbers[free]);
+
+        submit({commandType::CANCEL_RIDE, {freeNumbers[free], 0, 0}});
+        submit({commandType::INSERT,
+                {usedNumbers[used], int(rng() % 100000),
+                 int(rng() % 100000 + 1)}});
+
+        rideNumberType rideNumber = usedNumbers[rng() % usedNumbers.size()];
+        submit({commandType::UPDATE_TRIP,
+                {rideNumber, int(rng() % 100000 + 1), 0}});
+        submit({commandType::PRINT, {rideNumber, 0, 0}});
+      }
+    }
+
+    for (completionSlot &slot : slots) {
+      if (submitted-- > 0) {
+        sum += slot.wait().rides.size();
+      }
+    }
+    checksum += sum;
+  };
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < producers; t++) {
+    pool.emplace_back(producer, t, false);
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+  pool.clear();
+
+  long long allocationsBefore = allocationCount;
+  auto start = std::chrono::steady_clock::now();
+
+  for (int t = 0; t < producers; t++) {
+    pool.emplace_back(producer, t, true);
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+
+  auto stop = std::chrono::steady_clock::now();
+
+  if (checksum < 0) {
+    std::printf("%lld\n", checksum.load());
+  }
+
+  long long ops = 4 * rounds * producers;
+  return {ops, std::chrono::duration<double>(stop - start).count(),
+          allocationCount - allocationsBefore};
+}
+
+/**
+ * @brief Dispatches and inserts rides while logging both commands to a
+ * write-ahead log that commits groups of the given number of records.
+ *
+ * @details The time window of the log is left wide open, so only the group
+ * size decides when the log is synced.
+ *
+ * @param groupRecords Number of records per group commit.
+ * @param rides Number of active rides.
+ * @return The measurements of the workload, counting every command.
+ */
+template <typename Heap>
+benchResult runLogged(int groupRecords, long long rides) {
+  rideQueue<Heap> queue(rides);
+  for (long long i = 0; i < rides; i++) {
+    queue.insert();
+  }
+
+  long long rounds = std::min(rides, maxLoggedRounds);
+  long long allocationsBefore = allocationCount;
+  auto start = std::chrono::steady_clock::now();
+
+  {
+    writeAheadLog log(logFileName, 0, 0, groupRecords, std::chrono::hours(1));
+    for (long long i = 0; i < rounds; i++) {
+      queue.getNextRide();
+      log.append({commandType::GET_NEXT_RIDE, {0, 0, 0}});
+      queue.insert();
+      log.append({commandType::INSERT, {queue.usedNumbers.back(), 0, 0}});
+    }
+  }
+
+  auto stop = std::chrono::steady_clock::now();
+  unlink(logFileName);
+
+  return {2 * rounds, std::chrono::duration<double>(stop - start).count(),
+          allocationCount - allocationsBefore};
+}
+
+/**
+ * @brief Runs a workload in a child process, so that the peak RSS reported
+ * belongs to that workload alone, and prints one line of results.
+ *
+ * @param heapName Name of the heap printed in the results.
+ * @param workload Name of the workload.
+ * @param rides Number of active rides.
+ */
+template <typename Heap, typename Tree = rbTree, bool Indexed = false>
+void report(const char *heapName, const std::string &workload,
+            long long rides) {
+  std::fflush(stdout);
+  pid_t child = fork();
+
+  if (child == 0) {
+    // The threaded and logged workloads only exist for GatorTaxi's rides.
+    benchResult result;
+    if constexpr (std::is_same<typename Tree::nodeType, rbNode>::value) {
+      if (workload.compare(0, 6, "shard-") == 0) {
+        result = runSharded<Heap>(std::stoi(workload.substr(6)), rides);
+      } else if (workload.compare(0, 7, "ingest-") == 0) {
+        result = runIngest<Heap>(std::stoi(workload.substr(7)), rides);
+      } else if (workload.compare(0, 4, "log-") == 0) {
+        result = runLogged<Heap>(std::stoi(workload.substr(4)), rides);
+      } else if (workload.compare(0, 6, "zones-") == 0) {
+        result = runZones<Heap>(std::stoi(workload.substr(6)), rides);
+      } else {
+        result = runWorkload<Heap, Tree, Indexed>(workload, rides);
+      }
+    } else {
+      result = runWorkload<Heap, Tree, Indexed>(workload, rides);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    double nsPerOp = result.seconds * 1e9 / result.ops;
+    std::printf("%-14s %-9s %10lld %9lld %10.1f %12.0f %10.1f %10.3f\n",
+                heapName, workload.c_str(), rides, result.ops, nsPerOp,
+                result.ops / result.seconds, usage.ru_maxrss / 1024.0,
+                double(result.allocations) / result.ops);
+    std::fflush(stdout);
+    _exit(0);
+  }
+
+  int status;
+  waitpid(child, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::printf("%-14s %-9s %10lld failed\n", heapName, workload.c_str(),
+                rides);
+  }
+}
+
+} // namespace
+
+/**
+ * @brief Runs every workload for every requested number of active rides.
+ *
+ * @param argc the number of arguments passed to the program
+ * @param argv the numbers of active rides to benchmark, 1K, 100K and 10M by
+ * default
+ * @return 0 on success
+ */
+int main(int argc, char *argv[]) {
+  std::vector<long long> sizes;
+  for (int i = 1; i < argc; i++) {
+    sizes.push_back(std::atoll(argv[i]));
+  }
+  if (sizes.empty()) {
+    sizes = {1000, 100000, 10000000};
+  }
+
+  const char *workloads[] = {"insert", "dispatch", "cancel", "update",
+                             "print", "range"};
+
+  std::printf("%-14s %-9s %10s %9s %10s %12s %10s %10s\n", "heap", "workload",
+              "rides", "ops", "ns/op", "ops/s", "peakRSS_MB", "allocs/op");
+
+  // The rows named "/B+" index the rides with the B+-tree instead of the red
+  // black tree and those named "/H" find rides through a rideLookup. The
+  // threaded workloads run with 1, 2, 4, ... threads up to the number of
+  // hardware threads, as "shard-<threads>" on the sharded dispatcher, as
+  // "ingest-<producers>" on the ingest engine and as "zones-<threads>" on
+  // independent zones sharing a work-stealing pool. The logged workloads run
+  // as "log-<group>" for group commits of 1 to 4096 records.
+  int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (long long rides : sizes) {
+    for (const char *workload : workloads) {
+      report<minHeap<4>>("minHeap<4>", workload, rides);
+      report<packedHeap<8>>("packedHeap<8>", workload, rides);
+      report<pairingHeap>("pairingHeap", workload, rides);
+      report<minHeap<4>, bPlusTree>("minHeap<4>/B+", workload, rides);
+      report<minHeap<4>, rbTree, true>("minHeap<4>/H", workload, rides);
+    }
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      for (std::string prefix : {"shard-", "ingest-", "zones-"}) {
+        std::string workload = prefix + std::to_string(threads);
+        report<minHeap<4>>("minHeap<4>", workload, rides);
+        report<packedHeap<8>>("packedHeap<8>", workload, rides);
+      }
+    }
+    for (int group = 1; group <= 4096; group *= 16) {
+      report<minHeap<4>>("minHeap<4>", "log-" + std::to_string(group), rides);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include "binaryCommandReader.hpp"
+#include "binaryFormat.hpp"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Constructor for binaryCommandReader class.
+ *
+ * @param fileName Path of the binary command log.
+ * @throws std::runtime_error If the file cannot be opened or does not start
+ * with a binary command log header.
+ */
+binaryCommandReader::binaryCommandReader(const char *fileName)
+    : file(fileName), cursor(file.begin()), limit(file.end()) {
+  if (file.size() < binaryHeaderSize ||
+      !checkHeader(commandLogMagic, file.begin())) {
+    throw std::runtime_error(std::string(fileName) +
+                             " is not a binary command log");
+  }
+  cursor += binaryHeaderSize;
+}
+
+/**
+ * @brief Reads the next command from the log.
+ *
+ * @param cmd The command to fill in.
+ * @return True if a command was read, false at the end of the file or at a
+ * corrupt record.
+ */
+bool binaryCommandReader::next(command &cmd) {
+  if (cursor == limit) {
+    return false;
+  }
+
+  std::size_t recordSize =
+      getCommandRecordSize(static_cast<unsigned char>(*cursor));
+
+  if (recordSize == 0 || std::size_t(limit - cursor) < recordSize) {
+    std::cerr << "offset " << cursor - file.begin()
+              << ": corrupt binary command record\n";
+    limit = cursor;
+    return false;
+  }
+
+  decodeCommand(cursor, cmd);
+  cursor += recordSize;
+  return true;
+}
+
+/**
+ * @brief Returns the byte offset of the next record in the log.
+ *
+ * @return The offset, counted from the start of the file.
+ */
+std::size_t binaryCommandReader::getOffset() const {
+  return cursor - file.begin();
+}
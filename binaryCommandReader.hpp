@@ -0,0 +1,31 @@
+#ifndef BINARYCOMMANDREADER_H
+#define BINARYCOMMANDREADER_H
+
+#include "commandParser.hpp"
+#include "mappedFile.hpp"
+
+// Reader for binary command logs, see binaryFormat.hpp. The file is mapped
+// into memory and every record is decoded with a single copy of its operands.
+// A corrupt record is reported on standard error with its byte offset, and
+// reading stops there.
+class binaryCommandReader {
+private:
+  mappedFile file;    // The command log.
+  const char *cursor; // Start of the next record.
+  const char *limit;  // End of the records, or start of a corrupt one.
+
+public:
+  // Constructor maps the given file and checks its header.
+  // Throws std::runtime_error if the file cannot be opened or is not a binary
+  // command log.
+  explicit binaryCommandReader(const char *fileName);
+
+  // Reads the next command, returns false at the end of the file.
+  bool next(command &cmd);
+
+  // Returns the offset of the next record, which after the last command read
+  // is the size of the intact part of the log.
+  std::size_t getOffset() const;
+};
+
+#endif // BINARYCOMMANDREADER_H
@@ -0,0 +1,163 @@
+#include "binaryFormat.hpp"
+#include <cstring>
+
+/**
+ * @brief Returns the number of operands stored for a command.
+ *
+ * @param opcode The opcode of the command.
+ * @return The number of operands following the opcode, or -1 if the opcode
+ * does not name a command.
+ */
+int getOperandCount(int opcode) {
+  switch (static_cast<commandType>(opcode)) {
+  case commandType::INSERT:
+    return 3;
+  case commandType::GET_NEXT_RIDE:
+    return 0;
+  case commandType::PRINT:
+    return 1;
+  case commandType::PRINT_RANGE:
+    return 2;
+  case commandType::UPDATE_TRIP:
+    return 2;
+  case commandType::CANCEL_RIDE:
+    return 1;
+  case commandType::COUNT_IN_RANGE:
+    return 2;
+  case commandType::SELECT:
+    return 1;
+  case commandType::RANK:
+    return 1;
+  case commandType::GET_NEXT_RIDES:
+    return 1;
+  }
+  return -1;
+}
+
+/**
+ * @brief Writes the header of a binary file.
+ *
+ * @param magic The four magic bytes identifying the kind of file.
+ * @param header Destination of binaryHeaderSize bytes.
+ */
+void encodeHeader(const char magic[4], char *header) {
+  std::memcpy(header, magic, 4);
+  std::memcpy(header + 4, &binaryFormatVersion, sizeof(binaryFormatVersion));
+}
+
+/**
+ * @brief Checks the header of a binary file.
+ *
+ * @param magic The four magic bytes expected for the kind of file.
+ * @param header The first binaryHeaderSize bytes of the file.
+ * @return True if the magic bytes and the version match, false otherwise.
+ */
+bool checkHeader(const char magic[4], const char *header) {
+  std::uint32_t version;
+  std::memcpy(&version, header + 4, sizeof(version));
+  return std::memcmp(header, magic, 4) == 0 && version == binaryFormatVersion;
+}
+
+/**
+ * @brief Returns the size of the record of a command.
+ *
+ * @param opcode The opcode of the command.
+ * @return The opcode byte plus the 64-bit ride numbers and 32-bit other
+ * operands, or 0 if the opcode does not name a command.
+ */
+std::size_t getCommandRecordSize(int opcode) {
+  int operands = getOperandCount(opcode);
+  if (operands < 0) {
+    return 0;
+  }
+
+  int rideNumbers = getRideNumberArgs(static_cast<commandType>(opcode));
+  return 1 + rideNumbers * sizeof(std::int64_t) +
+         (operands - rideNumbers) * sizeof(std::int32_t);
+}
+
+/**
+ * @brief Encodes a command into a binary record.
+ *
+ * @param cmd The command to encode.
+ * @param record Destination of at least maxCommandRecordSize bytes.
+ * @return The number of bytes of the record.
+ */
+std::size_t encodeCommand(const command &cmd, char *record) {
+  int operands = getOperandCount(static_cast<int>(cmd.type));
+  int rideNumbers = getRideNumberArgs(cmd.type);
+  char *pos = record + 1;
+
+  record[0] = static_cast<char>(cmd.type);
+  for (int i = 0; i < operands; i++) {
+    if (i < rideNumbers) {
+      std::int64_t operand = cmd.args[i];
+      std::memcpy(pos, &operand, sizeof(operand));
+      pos += sizeof(operand);
+    } else {
+      std::int32_t operand = static_cast<std::int32_t>(cmd.args[i]);
+      std::memcpy(pos, &operand, sizeof(operand));
+      pos += sizeof(operand);
+    }
+  }
+  return pos - record;
+}
+
+/**
+ * @brief Decodes a binary record into a command.
+ *
+ * @param record The record, whose opcode must name a command and which must
+ * hold getCommandRecordSize bytes.
+ * @param cmd The command to fill in.
+ */
+void decodeCommand(const char *record, command &cmd) {
+  cmd.type = static_cast<commandType>(record[0]);
+  int operands = getOperandCount(static_cast<unsigned char>(record[0]));
+  int rideNumbers = getRideNumberArgs(cmd.type);
+  const char *pos = record + 1;
+
+  for (int i = 0; i < operands; i++) {
+    if (i < rideNumbers) {
+      std::int64_t operand;
+      std::memcpy(&operand, pos, sizeof(operand));
+      pos += sizeof(operand);
+      cmd.args[i] = operand;
+    } else {
+      std::int32_t operand;
+      std::memcpy(&operand, pos, sizeof(operand));
+      pos += sizeof(operand);
+      cmd.args[i] = operand;
+    }
+  }
+}
+
+/**
+ * @brief Encodes a ride as its 64-bit ride number followed by its 32-bit cost
+ * and duration.
+ *
+ * @param rideNumber The ride number.
+ * @param rideCost The ride cost.
+ * @param tripDuration The trip duration.
+ * @param record Destination of rideRecordSize bytes.
+ */
+void encodeRide(std::int64_t rideNumber, std::int32_t rideCost,
+                std::int32_t tripDuration, char *record) {
+  std::memcpy(record, &rideNumber, sizeof(rideNumber));
+  std::memcpy(record + 8, &rideCost, sizeof(rideCost));
+  std::memcpy(record + 12, &tripDuration, sizeof(tripDuration));
+}
+
+/**
+ * @brief Decodes a ride stored by encodeRide.
+ *
+ * @param record The rideRecordSize bytes of the ride.
+ * @param rideNumber Receives the ride number.
+ * @param rideCost Receives the ride cost.
+ * @param tripDuration Receives the trip duration.
+ */
+void decodeRide(const char *record, std::int64_t &rideNumber,
+                std::int32_t &rideCost, std::int32_t &tripDuration) {
+  std::memcpy(&rideNumber, record, sizeof(rideNumber));
+  std::memcpy(&rideCost, record + 8, sizeof(rideCost));
+  std::memcpy(&tripDuration, record + 12, sizeof(tripDuration));
+}
@@ -0,0 +1,83 @@
+#ifndef BINARYFORMAT_H
+#define BINARYFORMAT_H
+
+#include "commandParser.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the binary formats are stored in little-endian byte order"
+#endif
+
+// Binary command logs and binary result files start with an 8 byte header:
+// four magic bytes followed by the format version as a 32-bit integer.
+//
+// A command record is the opcode byte, which is the value of its commandType,
+// followed by the operands of that command: ride numbers as 64-bit integers
+// and all other operands as 32-bit integers. The width of a record is
+// therefore fixed by its opcode, from 1 byte for GetNextRide() to 17 bytes
+// for Insert() and the commands taking a range of ride numbers.
+//
+// A result file holds one record per value written by the dispatcher, tagged
+// with a resultTag byte: a ride is followed by its 64-bit rideNumber and its
+// 32-bit rideCost and tripDuration, a message by its 32-bit length and its
+// characters, a number by its 32-bit value, and the end of a result has no
+// payload.
+//
+// A snapshot holds the number of rides and the number of write-ahead log
+// records it already contains as 64-bit integers, followed by every ride in
+// ride number order, stored like the ride of a result record without the tag.
+// A write-ahead log is a binary command log.
+//
+// Version 1 stored ride numbers as 32-bit integers and is no longer read.
+//
+// All integers are stored in little-endian byte order.
+
+constexpr char commandLogMagic[4] = {'G', 'T', 'X', 'C'};
+constexpr char resultLogMagic[4] = {'G', 'T', 'X', 'R'};
+constexpr char snapshotMagic[4] = {'G', 'T', 'X', 'S'};
+constexpr std::uint32_t binaryFormatVersion = 2;
+constexpr std::size_t binaryHeaderSize = 8;
+constexpr std::size_t maxCommandRecordSize =
+    1 + 2 * sizeof(std::int64_t) + sizeof(std::int32_t);
+constexpr std::size_t rideRecordSize =
+    sizeof(std::int64_t) + 2 * sizeof(std::int32_t);
+constexpr std::size_t snapshotHeaderSize =
+    binaryHeaderSize + 2 * sizeof(std::uint64_t);
+constexpr std::size_t snapshotRecordSize = rideRecordSize;
+
+// Tags of the records in a binary result file.
+enum class resultTag : std::uint8_t {
+  RIDE = 1,
+  MESSAGE = 2,
+  END_OF_RESULT = 3,
+  NUMBER = 4
+};
+
+// Returns the number of operands stored for a command, or -1 for an opcode
+// that does not name a command.
+int getOperandCount(int opcode);
+
+// Returns the size of the record of a command, or 0 for an opcode that does
+// not name a command.
+std::size_t getCommandRecordSize(int opcode);
+
+// Writes the header of a binary file with the given magic bytes.
+void encodeHeader(const char magic[4], char *header);
+
+// Checks the header of a binary file, returns false if it does not match.
+bool checkHeader(const char magic[4], const char *header);
+
+// Encodes a command into a record and returns the size of the record.
+std::size_t encodeCommand(const command &cmd, char *record);
+
+// Decodes a record whose opcode names a command.
+void decodeCommand(const char *record, command &cmd);
+
+// Encodes a ride into rideRecordSize bytes, and decodes it.
+void encodeRide(std::int64_t rideNumber, std::int32_t rideCost,
+                std::int32_t tripDuration, char *record);
+void decodeRide(const char *record, std::int64_t &rideNumber,
+                std::int32_t &rideCost, std::int32_t &tripDuration);
+
+#endif // BINARYFORMAT_H
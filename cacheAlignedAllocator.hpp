@@ -0,0 +1,39 @@
+#ifndef CACHEALIGNEDALLOCATOR_H
+#define CACHEALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+// Size of a cache line on the targeted processors.
+constexpr std::size_t cacheLineSize = 64;
+
+// Allocator for standard containers that places the first element of every
+// allocation at the start of a cache line.
+template <typename T> class cacheAlignedAllocator {
+public:
+  using value_type = T;
+
+  cacheAlignedAllocator() = default;
+  template <typename U>
+  cacheAlignedAllocator(const cacheAlignedAllocator<U> &) {}
+
+  T *allocate(std::size_t count) {
+    return static_cast<T *>(
+        ::operator new(count * sizeof(T), std::align_val_t(cacheLineSize)));
+  }
+
+  void deallocate(T *memory, std::size_t) {
+    ::operator delete(memory, std::align_val_t(cacheLineSize));
+  }
+
+  template <typename U>
+  bool operator==(const cacheAlignedAllocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const cacheAlignedAllocator<U> &) const {
+    return false;
+  }
+};
+
+#endif // CACHEALIGNEDALLOCATOR_H
@@ -0,0 +1,266 @@
+#include "commandParser.hpp"
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Name, command type and accepted argument counts of every command.
+struct commandSpec {
+  const char *name;
+  std::size_t nameLength;
+  commandType type;
+  int minArgs, maxArgs;
+};
+
+const commandSpec commandSpecs[] = {
+    {"Insert", 6, commandType::INSERT, 3, 3},
+    {"GetNextRide", 11, commandType::GET_NEXT_RIDE, 0, 0},
+    {"Print", 5, commandType::PRINT, 1, 2},
+    {"UpdateTrip", 10, commandType::UPDATE_TRIP, 2, 2},
+    {"CancelRide", 10, commandType::CANCEL_RIDE, 1, 1},
+    {"CountInRange", 12, commandType::COUNT_IN_RANGE, 2, 2},
+    {"Select", 6, commandType::SELECT, 1, 1},
+    {"Rank", 4, commandType::RANK, 1, 1},
+    {"GetNextRides", 12, commandType::GET_NEXT_RIDES, 1, 1},
+};
+
+/**
+ * @brief Checks if a character is a blank, a space, a tab or the carriage
+ * return of a CRLF line ending.
+ *
+ * @param c The character.
+ * @return True if the character is a blank, false otherwise.
+ */
+bool isBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Skips blanks.
+ *
+ * @param pos The current position.
+ * @param end The end of the line.
+ * @return The first position that is not a blank.
+ */
+const char *skipBlanks(const char *pos, const char *end) {
+  while (pos < end && isBlank(*pos)) {
+    pos++;
+  }
+  return pos;
+}
+
+} // namespace
+
+/**
+ * @brief Returns the name of a command type.
+ *
+ * @param type The command type.
+ * @return The name of the command, range prints are named "Print(range)".
+ */
+const char *getCommandName(commandType type) {
+  switch (type) {
+  case commandType::INSERT:
+    return "Insert";
+  case commandType::GET_NEXT_RIDE:
+    return "GetNextRide";
+  case commandType::PRINT:
+    return "Print";
+  case commandType::PRINT_RANGE:
+    return "Print(range)";
+  case commandType::UPDATE_TRIP:
+    return "UpdateTrip";
+  case commandType::CANCEL_RIDE:
+    return "CancelRide";
+  case commandType::COUNT_IN_RANGE:
+    return "CountInRange";
+  case commandType::SELECT:
+    return "Select";
+  case commandType::RANK:
+    return "Rank";
+  case commandType::GET_NEXT_RIDES:
+    return "GetNextRides";
+  }
+  return "Unknown";
+}
+
+/**
+ * @brief Returns whether a command can change the active rides, which is what
+ * the write-ahead log records.
+ *
+ * @param type The command type.
+ * @return True for inserts, dispatches, updates and cancellations.
+ */
+bool changesRides(commandType type) {
+  switch (type) {
+  case commandType::INSERT:
+  case commandType::GET_NEXT_RIDE:
+  case commandType::UPDATE_TRIP:
+  case commandType::CANCEL_RIDE:
+  case commandType::GET_NEXT_RIDES:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Returns the number of leading arguments of a command that are ride
+ * numbers, which may exceed the int range.
+ *
+ * @param type The command type.
+ * @return The number of ride number arguments.
+ */
+int getRideNumberArgs(commandType type) {
+  switch (type) {
+  case commandType::PRINT_RANGE:
+  case commandType::COUNT_IN_RANGE:
+    return 2;
+  case commandType::INSERT:
+  case commandType::PRINT:
+  case commandType::UPDATE_TRIP:
+  case commandType::CANCEL_RIDE:
+  case commandType::RANK:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Constructor for commandParser class.
+ *
+ * @param fileName Path of the command file to map.
+ * @throws std::runtime_error If the file cannot be opened or mapped.
+ */
+commandParser::commandParser(const char *fileName)
+    : file(fileName), cursor(file.begin()), lineNumber(0) {}
+
+/**
+ * @brief Parses one line of the form Name(arg1,arg2,...).
+ *
+ * @param begin The first character of the line.
+ * @param end One past the last character of the line, without the newline.
+ * @param cmd The command to fill in.
+ * @return True if the line holds a valid command, false otherwise.
+ */
+bool commandParser::parseLine(const char *begin, const char *end,
+                              command &cmd) {
+  const char *pos = skipBlanks(begin, end);
+
+  // Find the command name, which ends at the opening parenthesis or a blank.
+  const char *nameEnd = pos;
+  while (nameEnd < end && *nameEnd != '(' && !isBlank(*nameEnd)) {
+    nameEnd++;
+  }
+
+  const commandSpec *spec = nullptr;
+  for (const commandSpec &candidate : commandSpecs) {
+    if (candidate.nameLength == std::size_t(nameEnd - pos) &&
+        std::memcmp(candidate.name, pos, candidate.nameLength) == 0) {
+      spec = &candidate;
+      break;
+    }
+  }
+  if (spec == nullptr) {
+    return false;
+  }
+
+  pos = skipBlanks(nameEnd, end);
+  if (pos == end || *pos != '(') {
+    return false;
+  }
+  pos = skipBlanks(pos + 1, end);
+
+  // Read the comma separated arguments up to the closing parenthesis.
+  int argCount = 0;
+  if (pos < end && *pos != ')') {
+    while (true) {
+      if (argCount == spec->maxArgs) {
+        return false;
+      }
+
+      std::from_chars_result result =
+          std::from_chars(pos, end, cmd.args[argCount]);
+      if (result.ec != std::errc()) {
+        return false;
+      }
+      argCount++;
+
+      pos = skipBlanks(result.ptr, end);
+      if (pos < end && *pos == ',') {
+        pos = skipBlanks(pos + 1, end);
+      } else {
+        break;
+      }
+    }
+  }
+
+  if (pos == end || *pos != ')' || skipBlanks(pos + 1, end) != end) {
+    return false;
+  }
+  if (argCount < spec->minArgs) {
+    return false;
+  }
+
+  cmd.type = spec->type;
+  if (spec->type == commandType::PRINT && argCount == 2) {
+    cmd.type = commandType::PRINT_RANGE;
+  }
+
+  // Only ride numbers may take more than an int.
+  for (int i = getRideNumberArgs(cmd.type); i < argCount; i++) {
+    if (cmd.args[i] < INT_MIN || cmd.args[i] > INT_MAX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Reads the next valid command from the file.
+ *
+ * @details Blank lines are skipped silently, malformed lines are reported on
+ * standard error with their line number and skipped.
+ *
+ * @param cmd The command to fill in.
+ * @return True if a command was read, false at the end of the file.
+ */
+bool commandParser::next(command &cmd) {
+  const char *fileEnd = file.end();
+
+  while (cursor < fileEnd) {
+    const char *lineEnd = static_cast<const char *>(
+        std::memchr(cursor, '\n', fileEnd - cursor));
+    if (lineEnd == nullptr) {
+      lineEnd = fileEnd;
+    }
+
+    const char *begin = cursor;
+    cursor = lineEnd < fileEnd ? lineEnd + 1 : fileEnd;
+    lineNumber++;
+
+    if (skipBlanks(begin, lineEnd) == lineEnd) {
+      continue;
+    }
+
+    if (parseLine(begin, lineEnd, cmd)) {
+      return true;
+    }
+
+    std::cerr << "line " << lineNumber << ": malformed command: ";
+    std::cerr.write(begin, lineEnd - begin) << '\n';
+  }
+
+  return false;
+}
+
+/**
+ * @brief Returns the number of the last line read.
+ *
+ * @return The line number, starting at 1.
+ */
+int commandParser::getLineNumber() const {
+  return lineNumber;
+}
@@ -0,0 +1,66 @@
+#ifndef COMMANDPARSER_H
+#define COMMANDPARSER_H
+
+#include "mappedFile.hpp"
+#include <cstdint>
+
+// The commands understood by the dispatcher. The values double as the opcodes
+// of the binary command format, so they must never change.
+enum class commandType {
+  INSERT = 1,
+  GET_NEXT_RIDE = 2,
+  PRINT = 3,
+  PRINT_RANGE = 4,
+  UPDATE_TRIP = 5,
+  CANCEL_RIDE = 6,
+  COUNT_IN_RANGE = 7,
+  SELECT = 8,
+  RANK = 9,
+  GET_NEXT_RIDES = 10
+};
+
+// Number of command types.
+const int commandTypeCount = 10;
+
+// Returns the name of a command type, as used in reports.
+const char *getCommandName(commandType type);
+
+// Returns whether a command can change the active rides.
+bool changesRides(commandType type);
+
+// Returns the number of leading arguments of a command that are ride numbers.
+// They take 64 bits, every other argument fits an int.
+int getRideNumberArgs(commandType type);
+
+// A parsed command with its integer arguments.
+struct command {
+  commandType type;
+  std::int64_t args[3];
+};
+
+// Parser for text command files such as "Insert(5,50,120)". The file is
+// mapped into memory and tokenized in place, so parsing a line never
+// allocates. Malformed lines are reported on standard error with their line
+// number and skipped.
+class commandParser {
+private:
+  mappedFile file;    // The command file.
+  const char *cursor; // Start of the next line to parse.
+  int lineNumber;     // Number of the last line read.
+
+  // Parses a single line, returns false if it is not a valid command.
+  bool parseLine(const char *begin, const char *end, command &cmd);
+
+public:
+  // Constructor maps the given file.
+  // Throws std::runtime_error if the file cannot be opened or mapped.
+  explicit commandParser(const char *fileName);
+
+  // Reads the next valid command, returns false at the end of the file.
+  bool next(command &cmd);
+
+  // Returns the number of the last line read.
+  int getLineNumber() const;
+};
+
+#endif // COMMANDPARSER_H
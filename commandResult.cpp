@@ -0,0 +1,82 @@
+#include "commandResult.hpp"
+
+namespace {
+
+/**
+ * @brief Writes a list of rides on one line, in the layout of a range print.
+ *
+ * @param rides The rides to write, at least one.
+ * @param out The output writer the rides are written to.
+ */
+void writeRides(const std::vector<rideInfo> &rides, outputWriter &out) {
+  for (std::size_t i = 0; i < rides.size(); i++) {
+    if (i > 0) {
+      out.writeSeparator(',');
+    }
+    out.writeRide(rides[i].rideNumber, rides[i].rideCost,
+                  rides[i].tripDuration);
+  }
+  out.writeSeparator(' ');
+}
+
+} // namespace
+
+/**
+ * @brief Writes the result of a command in the output format of gatorTaxi.
+ *
+ * @param cmd The command that was executed.
+ * @param result The result of the command.
+ * @param out The output writer the result is written to.
+ * @return false if the command inserted a duplicate ride number, true
+ * otherwise.
+ */
+bool writeResult(const command &cmd, const commandResult &result,
+                 outputWriter &out) {
+  switch (cmd.type) {
+  case commandType::INSERT:
+    if (result.number == 0) {
+      out.writeString("Duplicate RideNumber\n");
+      out.endLine();
+      return false;
+    }
+    return true;
+  case commandType::UPDATE_TRIP:
+  case commandType::CANCEL_RIDE:
+    return true;
+  case commandType::COUNT_IN_RANGE:
+  case commandType::RANK:
+    out.writeNumber(result.number);
+    break;
+  case commandType::GET_NEXT_RIDE:
+  case commandType::GET_NEXT_RIDES:
+    // A GetNextRides with a count of zero or less dispatches nothing, even
+    // when there are rides, so its line stays empty.
+    if (cmd.type == commandType::GET_NEXT_RIDES && cmd.args[0] <= 0) {
+      break;
+    }
+    if (result.rides.empty()) {
+      out.writeString("No active ride requests");
+    } else if (cmd.type == commandType::GET_NEXT_RIDE) {
+      const rideInfo &ride = result.rides[0];
+      out.writeRide(ride.rideNumber, ride.rideCost, ride.tripDuration);
+    } else {
+      writeRides(result.rides, out);
+    }
+    break;
+  case commandType::PRINT:
+  case commandType::SELECT:
+  case commandType::PRINT_RANGE:
+    if (result.rides.empty()) {
+      out.writeRide(0, 0, 0);
+    } else if (cmd.type == commandType::PRINT_RANGE) {
+      writeRides(result.rides, out);
+    } else {
+      const rideInfo &ride = result.rides[0];
+      out.writeRide(ride.rideNumber, ride.rideCost, ride.tripDuration);
+    }
+    break;
+  }
+
+  out.endLine();
+  return true;
+}
@@ -0,0 +1,85 @@
+#ifndef COMMANDRESULT_H
+#define COMMANDRESULT_H
+
+#include "commandParser.hpp"
+#include "outputWriter.hpp"
+#include "rideStore.hpp"
+#include <vector>
+
+// The result of one command, computed apart from writing it so that it can
+// be handed from the thread executing the command to the one writing output.
+struct commandResult {
+  // 1 for a successful insert and 0 for a duplicate one, the count of
+  // CountInRange and Rank, and unused otherwise.
+  int number;
+
+  // The rides found or dispatched, in output order.
+  std::vector<rideInfo> rides;
+};
+
+// Executes a command on a rideStore or shardedDispatcher, which share the
+// same operations, and stores its result.
+template <typename Rides>
+void applyCommand(Rides &rides, const command &cmd, commandResult &result);
+
+// Writes the result of a command in the output format of gatorTaxi. Returns
+// false if the command was an insert of a duplicate ride number, after which
+// the program has to stop.
+bool writeResult(const command &cmd, const commandResult &result,
+                 outputWriter &out);
+
+/**
+ * @brief Executes a command and stores its result.
+ *
+ * @param rides The rides the command is executed on.
+ * @param cmd The command to execute.
+ * @param result Receives the result, its ride list is cleared first.
+ */
+template <typename Rides>
+void applyCommand(Rides &rides, const command &cmd, commandResult &result) {
+  rideInfo ride;
+
+  result.number = 0;
+  result.rides.clear();
+
+  switch (cmd.type) {
+  case commandType::INSERT:
+    result.number = rides.insert(cmd.args[0], cmd.args[1], cmd.args[2]);
+    break;
+  case commandType::GET_NEXT_RIDE:
+    if (rides.getNextRide(ride)) {
+      result.rides.push_back(ride);
+    }
+    break;
+  case commandType::PRINT:
+    if (rides.find(cmd.args[0], ride)) {
+      result.rides.push_back(ride);
+    }
+    break;
+  case commandType::PRINT_RANGE:
+    rides.findInRange(cmd.args[0], cmd.args[1], result.rides);
+    break;
+  case commandType::UPDATE_TRIP:
+    rides.updateTrip(cmd.args[0], cmd.args[1]);
+    break;
+  case commandType::CANCEL_RIDE:
+    rides.cancelRide(cmd.args[0]);
+    break;
+  case commandType::COUNT_IN_RANGE:
+    result.number = rides.countInRange(cmd.args[0], cmd.args[1]);
+    break;
+  case commandType::SELECT:
+    if (rides.select(cmd.args[0], ride)) {
+      result.rides.push_back(ride);
+    }
+    break;
+  case commandType::RANK:
+    result.number = rides.rank(cmd.args[0]);
+    break;
+  case commandType::GET_NEXT_RIDES:
+    rides.getNextRides(cmd.args[0], result.rides);
+    break;
+  }
+}
+
+#endif // COMMANDRESULT_H
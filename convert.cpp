@@ -0,0 +1,45 @@
+#include "binaryFormat.hpp"
+#include "commandParser.hpp"
+#include "outputWriter.hpp"
+#include <iostream>
+
+/**
+ * @brief Converts a text command file into a binary command log.
+ *
+ * @param argc the number of arguments passed to the program
+ * @param argv array of pointers to strings containing the arguments passed to
+ * the program
+ * @return 0 if the conversion succeeds, 1 otherwise
+ */
+int main(int argc, char *argv[]) {
+  // Check that the program is called with an input and an output file
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " input_file_name output_file_name\n";
+    return 1;
+  }
+
+  try {
+    commandParser parser(argv[1]);
+    outputWriter out(argv[2]);
+
+    char record[maxCommandRecordSize];
+    encodeHeader(commandLogMagic, record);
+    out.writeBytes(record, binaryHeaderSize);
+
+    // Encode every valid command, malformed lines are reported by the parser.
+    command cmd;
+    long long count = 0;
+    while (parser.next(cmd)) {
+      out.writeBytes(record, encodeCommand(cmd, record));
+      count++;
+    }
+
+    std::cout << "Converted " << count << " commands from "
+              << parser.getLineNumber() << " lines\n";
+  } catch (const std::exception &err) {
+    std::cout << "Error: " << err.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
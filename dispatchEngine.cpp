@@ -0,0 +1,543 @@
+#include "dispatchEngine.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Constructor for dispatchEngine class.
+ *
+ * @param heap The priority queue the rides are kept in.
+ * @param lookup Whether to find rides by ride number in a lookup table.
+ */
+dispatchEngine::dispatchEngine(std::unique_ptr<priorityQueue> heap,
+                               bool lookup)
+    : heap(std::move(heap)), lookup(lookup ? new rideLookup() : nullptr),
+      log(nullptr) {}
+
+/**
+ * @brief Destructor for dispatchEngine class.
+ */
+dispatchEngine::~dispatchEngine() {}
+
+/**
+ * @brief Sets the write-ahead log the engine appends to.
+ *
+ * @param newLog The log, or nullptr for none.
+ */
+void dispatchEngine::setLog(writeAheadLog *newLog) {
+  log = newLog;
+}
+
+/**
+ * @brief Appends a command to the write-ahead log, if there is one and the
+ * command can change the rides.
+ *
+ * @details GetNextRide and GetNextRides are not logged as commands, since the
+ * ride they take among rides of equal cost and duration depends on the shape
+ * of the heap, which a replay does not rebuild. They log the rides they
+ * dispatched through logDispatch instead.
+ *
+ * @param cmd The command that was executed.
+ */
+void dispatchEngine::logCommand(const command &cmd) {
+  if (log != nullptr && changesRides(cmd.type) &&
+      cmd.type != commandType::GET_NEXT_RIDE &&
+      cmd.type != commandType::GET_NEXT_RIDES) {
+    log->append(cmd);
+  }
+}
+
+/**
+ * @brief Appends a dispatched ride to the write-ahead log as a CancelRide of
+ * its ride number, which removes exactly that ride when the log is replayed.
+ *
+ * @details It must be called before the ride is written to the output, so
+ * that a flush of the output, which commits the log first, never shows a
+ * dispatch whose record is not in the log.
+ *
+ * @param ride The dispatched ride.
+ */
+void dispatchEngine::logDispatch(const rbNode *ride) {
+  if (log != nullptr) {
+    command cancel;
+    cancel.type = commandType::CANCEL_RIDE;
+    cancel.args[0] = ride->rideNumber;
+    log->append(cancel);
+  }
+}
+
+/**
+ * @brief Commits the write-ahead log and returns the number of records in it,
+ * which are all contained in a snapshot taken now.
+ *
+ * @return The number of log records, 0 without a log.
+ */
+std::uint64_t dispatchEngine::commitLog() {
+  if (log == nullptr) {
+    return 0;
+  }
+  log->commit();
+  return log->getRecordCount();
+}
+
+/**
+ * @brief Finds the ride with the given ride number, in the lookup table if
+ * there is one and in the tree otherwise.
+ *
+ * @param rideNumber The ride number.
+ * @return The red black node of the ride, or nullptr if there is none.
+ */
+rbNode *dispatchEngine::findRide(rideNumberType rideNumber) {
+  if (lookup) {
+    return lookup->find(rideNumber);
+  }
+  return tree.search(rideNumber);
+}
+
+/**
+ * @brief Deletes a ride from the tree and the lookup table. The heap node of
+ * the ride must be removed by the caller.
+ *
+ * @param ride The red black node of the ride, which is recycled.
+ */
+void dispatchEngine::deleteRide(rbNode *ride) {
+  if (lookup) {
+    lookup->erase(ride->rideNumber);
+  }
+  tree.deleteNode(ride);
+}
+
+/**
+* @brief This function inserts the ride information into both the red black tree
+* and minheap.
+*
+* @param ridenumber, rideCost, tripDuration the ride information to be inserted
+* @param out The output writer to output if duplicate ridenumber is inserted
+* @return false if the ride number is already in use, true otherwise.
+*/
+bool dispatchEngine::insert(rideNumberType rideNumber, int rideCost,
+                            int tripDuration, outputWriter &out) {
+  // Create a new red-black tree node with the given ride number, cost, and
+  // duration.
+  rbNode *rbnode = tree.createNode({rideNumber, rideCost, tripDuration});
+
+  try {
+    // Insert the new red-black tree node into the red-black tree.
+    tree.insert(rbnode);
+    if (lookup) {
+      lookup->insert(rbnode);
+    }
+
+    // Insert the ride into the heap, which links the heap node and the
+    // red-black tree node to each other.
+    heap->insert(rbnode);
+  } catch (const std::exception &err) {
+    // If an exception is thrown during the insertion due to duplicate
+    // ridenNumber, print out the error message using the output writer.
+    out.writeString(err.what());
+    out.endLine();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Inserts a run of rides into both the red black tree and the min heap.
+ *
+ * @details A long run is loaded in bulk: the tree is rebuilt from the sorted
+ * rides and the heap is restored bottom-up, both in linear time. Rebuilding
+ * touches every ride already in the tree, so short runs, and runs much smaller
+ * than the tree, are inserted one ride at a time instead. If the run contains
+ * a duplicate ride number, nothing is loaded and the rides are inserted one at
+ * a time as well, which stops at the duplicate exactly like single inserts.
+ * The inserts that succeeded are appended to the write-ahead log.
+ *
+ * @param inserts The insert commands of the run, in input order.
+ * @param out The output writer to output if duplicate ridenumber is inserted
+ * @return false if a ride number was already in use, true otherwise.
+ */
+bool dispatchEngine::bulkInsert(const std::vector<command> &inserts,
+                                outputWriter &out) {
+  if (inserts.size() < bulkInsertMinimum ||
+      8 * inserts.size() < tree.getSize()) {
+    for (const command &cmd : inserts) {
+      if (!execute(cmd, out)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Allocate the nodes in ride number order, so that neighbours in the tree
+  // are neighbours in memory as well.
+  std::vector<command> sorted(inserts);
+  std::sort(sorted.begin(), sorted.end(),
+            [](const command &a, const command &b) {
+              return a.args[0] < b.args[0];
+            });
+
+  std::vector<rbNode *> rides;
+  rides.reserve(inserts.size());
+  for (const command &cmd : sorted) {
+    // The parser has already checked that the cost and duration fit an int.
+    rides.push_back(tree.createNode({cmd.args[0], static_cast<int>(cmd.args[1]),
+                                     static_cast<int>(cmd.args[2])}));
+  }
+
+  try {
+    tree.bulkInsert(rides);
+  } catch (const std::exception &) {
+    for (rbNode *ride : rides) {
+      tree.destroyNode(ride);
+    }
+    for (const command &cmd : inserts) {
+      if (!execute(cmd, out)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  heap->bulkInsert(rides);
+  if (lookup) {
+    for (rbNode *ride : rides) {
+      lookup->insert(ride);
+    }
+  }
+  for (const command &cmd : inserts) {
+    logCommand(cmd);
+  }
+  return true;
+}
+
+/**
+This function retrieves the next ride from a heap data structure, deletes it
+from the red black tree as well as the heap, and writes it to an output file
+stream object.
+@param out The output writer to which the next ride will be written.
+*/
+void dispatchEngine::getNextRide(outputWriter &out) {
+  try {
+    // Remove the minimum heap node from the heap.
+    rbNode *nextRide = heap->removeMin();
+    logDispatch(nextRide);
+    out.writeRide(nextRide->rideNumber, nextRide->rideCost,
+                  nextRide->tripDuration);
+    out.endLine();
+    deleteRide(nextRide);
+  } catch (const std::exception &err) {
+    out.writeString(err.what());
+    out.endLine();
+  }
+}
+
+/**
+ * @brief Dispatches up to count rides at once, removing them from both the
+ * min heap and the red black tree and writing them on one line in priority
+ * order.
+ *
+ * @details The rides are taken from the heap in one loop and then deleted
+ * from the tree as a batch, which rebuilds the tree when the batch is large
+ * compared to it. A count of zero or less dispatches nothing and writes an
+ * empty line, "No active ride requests" is only written for an empty heap.
+ *
+ * @param count The maximum number of rides to dispatch.
+ * @param out The output writer to which the rides will be written.
+ */
+void dispatchEngine::getNextRides(int count, outputWriter &out) {
+  if (count <= 0) {
+    out.endLine();
+    return;
+  }
+
+  std::vector<rbNode *> rides;
+  heap->removeMins(count, rides);
+
+  if (rides.empty()) {
+    out.writeString("No active ride requests");
+    out.endLine();
+    return;
+  }
+
+  // Log every ride before any of them is written
+  for (rbNode *ride : rides) {
+    logDispatch(ride);
+  }
+
+  // Same layout as the list written by a range print
+  for (std::size_t i = 0; i < rides.size(); i++) {
+    if (i > 0) {
+      out.writeSeparator(',');
+    }
+    out.writeRide(rides[i]->rideNumber, rides[i]->rideCost,
+                  rides[i]->tripDuration);
+  }
+  out.writeSeparator(' ');
+  out.endLine();
+
+  if (lookup) {
+    for (rbNode *ride : rides) {
+      lookup->erase(ride->rideNumber);
+    }
+  }
+  tree.deleteNodes(rides);
+}
+
+/**
+ * @brief Prints the details of the ride with given rideNumber
+ *
+ * @param rideNumber The ride number to be printed
+ * @param out The output stream to print the details to
+ * If the ride is not found, "(0,0,0)" is printed.
+ */
+void dispatchEngine::print(rideNumberType rideNumber, outputWriter &out) {
+  rbNode *ride = findRide(rideNumber); // Search for the ridenumber node
+
+  // if node not exist then write (0,0,0) otherwise the found ride
+  if (ride == nullptr) {
+    out.writeRide(0, 0, 0);
+  } else {
+    out.writeRide(ride->rideNumber, ride->rideCost, ride->tripDuration);
+  }
+  out.endLine();
+}
+
+/**
+ * @brief Prints the details of all rides with ride numbers in the given range
+ *
+ * @param rideNumber1 The start ride number of the range (inclusive)
+ * @param rideNumber2 The end ride number of the range (inclusive)
+ * @param out The output stream to print the details to
+ * If no rides are found in the range, "(0,0,0)" is printed.
+ */
+void dispatchEngine::print(rideNumberType rideNumber1,
+                           rideNumberType rideNumber2, outputWriter &out) {
+  bool found = false;
+
+  // Stream the ride nodes in the range straight from the red black tree
+  tree.forEachInRange(rideNumber1, rideNumber2, [&](const rbNode &ride) {
+    if (found) {
+      out.writeSeparator(',');
+    }
+    out.writeRide(ride.rideNumber, ride.rideCost, ride.tripDuration);
+    found = true;
+  });
+
+  // if nodes do not exist then write (0,0,0) otherwise end the list of rides
+  if (found) {
+    out.writeSeparator(' ');
+  } else {
+    out.writeRide(0, 0, 0);
+  }
+  out.endLine();
+}
+
+/**
+ * @brief Cancels the ride with given ride number
+ *
+ * @param rideNumber The ride number to be cancelled
+ * Removes the ride from the red-black tree and the heap.
+ */
+void dispatchEngine::cancelRide(rideNumberType rideNumber) {
+  rbNode *ride = findRide(rideNumber); // Search for node with the ridenumber
+
+  // check if node exist
+  if (ride != nullptr) {
+    int idx = ride->getHeapHandle();
+    deleteRide(ride);   // Delete node from the tree and lookup
+    heap->remove(idx);  // Delete node from heap
+  }
+}
+
+/**
+ * @brief Updates the trip duration of a ride if the new duration is not more
+ * than twice the current duration
+ *
+ * @param rideNumber The ride number of the ride to be updated
+ * @param newTripDuration The new trip duration to be updated to
+ * The ride keeps its red-black tree node, since the ride number does not
+ * change, and only its heap node is moved. If the new trip duration is less
+ * than or equal to the current duration, rideCost remains the same. If the new
+ * trip duration is more than the current duration and less than twice its
+ * current duration, rideCost increases by 10. Otherwise the ride is declined
+ * and removed from the red-black tree and the heap.
+ */
+void dispatchEngine::updateTrip(rideNumberType rideNumber,
+                                int newTripDuration) {
+  rbNode *ride = findRide(rideNumber);
+  if (ride != nullptr) {
+    int currTripDuration = ride->tripDuration;
+
+    // if new trip duration is lesser than twice of previous tripduration then
+    // update the ride in place
+    if (newTripDuration <= 2 * currTripDuration) {
+      // ridecost stays the same if the trip does not get longer otherwise add
+      // 10 to previous value
+      ride->rideCost += newTripDuration <= currTripDuration ? 0 : 10;
+      ride->tripDuration = newTripDuration;
+
+      heap->update(ride); // Move the heap node to its new position.
+    } else {
+      // Remove ride from both the red black tree and min heap.
+      int idx = ride->getHeapHandle();
+      deleteRide(ride);
+      heap->remove(idx);
+    }
+  }
+}
+
+/**
+ * @brief Prints the number of rides with ride numbers in the given range
+ *
+ * @param rideNumber1 The start ride number of the range (inclusive)
+ * @param rideNumber2 The end ride number of the range (inclusive)
+ * @param out The output stream to print the count to
+ */
+void dispatchEngine::countInRange(rideNumberType rideNumber1,
+                                  rideNumberType rideNumber2,
+                                  outputWriter &out) {
+  out.writeNumber(tree.countInRange(rideNumber1, rideNumber2));
+  out.endLine();
+}
+
+/**
+ * @brief Prints the ride at the given position in ride number order
+ *
+ * @param k The position of the ride, counting from 1
+ * @param out The output stream to print the details to
+ * If there are fewer than k rides, "(0,0,0)" is printed.
+ */
+void dispatchEngine::select(int k, outputWriter &out) {
+  rbNode *ride = tree.select(k);
+
+  if (ride == nullptr) {
+    out.writeRide(0, 0, 0);
+  } else {
+    out.writeRide(ride->rideNumber, ride->rideCost, ride->tripDuration);
+  }
+  out.endLine();
+}
+
+/**
+ * @brief Prints the number of rides with a ride number not above the given
+ * one, which is the position of the ride in ride number order if it exists
+ *
+ * @param rideNumber The ride number to rank
+ * @param out The output stream to print the rank to
+ */
+void dispatchEngine::rank(rideNumberType rideNumber, outputWriter &out) {
+  out.writeNumber(tree.rank(rideNumber));
+  out.endLine();
+}
+
+/**
+ * @brief Executes a single parsed command and appends it to the write-ahead
+ * log. A failed insert is not logged.
+ *
+ * @param cmd The command to execute.
+ * @param out The output writer the results are written to.
+ * @return false if the command inserted a duplicate ride number, true
+ * otherwise.
+ */
+bool dispatchEngine::execute(const command &cmd, outputWriter &out) {
+  switch (cmd.type) {
+  case commandType::INSERT:
+    if (!insert(cmd.args[0], cmd.args[1], cmd.args[2], out)) {
+      return false;
+    }
+    break;
+  case commandType::GET_NEXT_RIDE:
+    getNextRide(out);
+    break;
+  case commandType::PRINT:
+    print(cmd.args[0], out);
+    break;
+  case commandType::PRINT_RANGE:
+    print(cmd.args[0], cmd.args[1], out);
+    break;
+  case commandType::UPDATE_TRIP:
+    updateTrip(cmd.args[0], cmd.args[1]);
+    break;
+  case commandType::CANCEL_RIDE:
+    cancelRide(cmd.args[0]);
+    break;
+  case commandType::COUNT_IN_RANGE:
+    countInRange(cmd.args[0], cmd.args[1], out);
+    break;
+  case commandType::SELECT:
+    select(cmd.args[0], out);
+    break;
+  case commandType::RANK:
+    rank(cmd.args[0], out);
+    break;
+  case commandType::GET_NEXT_RIDES:
+    getNextRides(cmd.args[0], out);
+    break;
+  }
+
+  logCommand(cmd);
+  return true;
+}
+
+/**
+ * @brief Loads the rides of a snapshot into the red black tree and min heap.
+ *
+ * @details The rides come in ride number order and the nodes are allocated
+ * in that order, so the tree is built without sorting and the heap bottom-up,
+ * both in time linear in the number of rides.
+ *
+ * @param fileName Path of the snapshot.
+ * @return The number of write-ahead log records the snapshot contains.
+ * @throws std::runtime_error If the snapshot cannot be read or holds a ride
+ * number twice.
+ */
+std::uint64_t dispatchEngine::restoreSnapshot(const char *fileName) {
+  std::vector<rideInfo> rides;
+  std::uint64_t logPosition = readSnapshot(fileName, rides);
+
+  std::vector<rbNode *> nodes;
+  nodes.reserve(rides.size());
+  for (const rideInfo &ride : rides) {
+    nodes.push_back(tree.createNode(ride));
+  }
+
+  try {
+    tree.bulkInsert(nodes);
+  } catch (const std::exception &) {
+    throw std::runtime_error(std::string(fileName) +
+                             " holds a ride number twice");
+  }
+  heap->bulkInsert(nodes);
+  if (lookup) {
+    for (rbNode *node : nodes) {
+      lookup->insert(node);
+    }
+  }
+  return logPosition;
+}
+
+/**
+ * @brief Starts a background snapshot of the rides.
+ *
+ * @details The log is committed first, so that it never ends before a
+ * snapshot that claims to contain its records.
+ *
+ * @param fileName Path of the snapshot.
+ * @return The process id of the process writing the snapshot.
+ * @throws std::runtime_error If the process cannot be created.
+ */
+pid_t dispatchEngine::startSnapshot(const char *fileName) {
+  return ::startSnapshot(tree, fileName, commitLog());
+}
+
+/**
+ * @brief Writes a snapshot of the rides and waits until it is complete.
+ *
+ * @param fileName Path of the snapshot.
+ * @throws std::runtime_error If the snapshot cannot be written.
+ */
+void dispatchEngine::writeSnapshot(const char *fileName) {
+  ::writeSnapshot(tree, fileName, commitLog());
+}
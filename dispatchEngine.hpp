@@ -0,0 +1,110 @@
+#ifndef DISPATCHENGINE_H
+#define DISPATCHENGINE_H
+
+#include "bPlusTree.hpp"
+#include "commandParser.hpp"
+#include "outputWriter.hpp"
+#include "priorityQueue.hpp"
+#include "rbTree.hpp"
+#include "rideLookup.hpp"
+#include "writeAheadLog.hpp"
+#include <cstdint>
+#include <memory>
+#include <sys/types.h>
+#include <vector>
+
+// Index of the active rides by ride number, the B+-tree if built with
+// "make INDEX=bplus" and the red black tree otherwise.
+#ifdef GATOR_BPLUS_INDEX
+using rideIndex = bPlusTree;
+#else
+using rideIndex = rbTree;
+#endif
+
+// One complete GatorTaxi: the index of the rides, their priority queue, the
+// optional lookup table and the optional write-ahead log, which executes
+// commands and writes their results. An engine shares no mutable state with
+// any other, down to the sentinel of its tree, so several engines can run in
+// one process, each driven by its own thread. A single engine is not
+// thread-safe.
+class dispatchEngine {
+private:
+  // Runs of consecutive inserts shorter than this are inserted one at a time.
+  static constexpr std::size_t bulkInsertMinimum = 64;
+
+  rideIndex tree;
+  std::unique_ptr<priorityQueue> heap;
+  std::unique_ptr<rideLookup> lookup; // nullptr without a lookup table.
+  writeAheadLog *log;                 // nullptr without a log.
+
+  // Appends a command to the log, if there is one and the command can change
+  // the rides. Dispatches are logged by logDispatch instead.
+  void logCommand(const command &cmd);
+
+  // Appends a dispatched ride to the log as a cancellation of its ride
+  // number, if there is a log.
+  void logDispatch(const rbNode *ride);
+
+  // Commits the log and returns the number of records in it, 0 without a
+  // log.
+  std::uint64_t commitLog();
+
+  // Finds a ride in the lookup table if there is one and in the tree
+  // otherwise, returning nullptr if it does not exist.
+  rbNode *findRide(rideNumberType rideNumber);
+
+  // Deletes a ride from the tree and the lookup table, but not the heap.
+  void deleteRide(rbNode *ride);
+
+  // The commands of GatorTaxi. Insert returns false after writing the error
+  // of a duplicate ride number.
+  bool insert(rideNumberType rideNumber, int rideCost, int tripDuration,
+              outputWriter &out);
+  void getNextRide(outputWriter &out);
+  void getNextRides(int count, outputWriter &out);
+  void print(rideNumberType rideNumber, outputWriter &out);
+  void print(rideNumberType rideNumber1, rideNumberType rideNumber2,
+             outputWriter &out);
+  void cancelRide(rideNumberType rideNumber);
+  void updateTrip(rideNumberType rideNumber, int newTripDuration);
+  void countInRange(rideNumberType rideNumber1, rideNumberType rideNumber2,
+                    outputWriter &out);
+  void select(int k, outputWriter &out);
+  void rank(rideNumberType rideNumber, outputWriter &out);
+
+public:
+  // Constructor for an engine without rides, keeping them in the given heap
+  // and, if lookup is set, in a lookup table as well.
+  dispatchEngine(std::unique_ptr<priorityQueue> heap, bool lookup);
+  ~dispatchEngine();
+
+  // The rides point into the tree, so an engine cannot be copied or moved.
+  dispatchEngine(const dispatchEngine &) = delete;
+  dispatchEngine &operator=(const dispatchEngine &) = delete;
+
+  // Appends the commands that change the rides to the given log from now on,
+  // or to no log if it is nullptr. The log must outlive the engine.
+  void setLog(writeAheadLog *newLog);
+
+  // Executes a command, writes its result and logs it. Returns false if the
+  // command was an insert of a duplicate ride number, after which the program
+  // has to stop.
+  bool execute(const command &cmd, outputWriter &out);
+
+  // Executes a run of consecutive inserts, loading long runs in bulk, and
+  // logs them. Returns false like execute.
+  bool bulkInsert(const std::vector<command> &inserts, outputWriter &out);
+
+  // Loads the rides of a snapshot into the empty engine and returns the
+  // number of log records the snapshot contains.
+  // Throws std::runtime_error if the snapshot cannot be read or holds a ride
+  // number twice.
+  std::uint64_t restoreSnapshot(const char *fileName);
+
+  // Commits the log and writes a snapshot of the rides, in the background or
+  // right away. See snapshot.hpp.
+  pid_t startSnapshot(const char *fileName);
+  void writeSnapshot(const char *fileName);
+};
+
+#endif // DISPATCHENGINE_H
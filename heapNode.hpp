@@ -3,33 +3,108 @@
 
 #include <iostream>
 
-// Forward declaration of the rbNode class, since it is used in the heap Node
-// class.
-class rbNode;
-
-class heapNode {
+// A heap node only holds the priority of a ride and a link to its red-black
+// node, which holds the rest of the ride. For GatorTaxi the priority is the
+// ride cost and the trip duration, which keeps the node at 16 bytes, so that
+// four siblings of a 4-ary heap fill exactly one cache line.
+//
+// Priority is an order policy as described in rideTypes.hpp. The member
+// functions are defined in this header, so the heaps inline every
+// comparison.
+template <typename Node, typename Priority> class basicHeapNode {
 private:
-  int rideNumber, rideCost, tripDuration; // Data values held by the node.
-  rbNode *rbNodeRef; // A pointer to the corresponding red-black node in red
+  using keyType = typename Priority::keyType;
+
+  keyType key;       // Priority of the ride held by the node.
+  Node *rbNodeRef;   // A pointer to the corresponding red-black node in red
                      // black tree.
 public:
-  int pos = 0; // position of this heap node in heap array.
-
   // Constructor and destructor.
-  heapNode(int rideNumber, int rideCost, int tripDuration);
-  ~heapNode();
+  explicit basicHeapNode(keyType key);
+  ~basicHeapNode();
 
-  // Less-than operator overload for heapNode class.
-  // The comparison is first done on the basis of the ride cost and if the ride
-  //  cost is the same, then it is done based on the trip duration.
-  bool operator<(const heapNode &other) const;
+  // Less-than operator overload for heapNode class, comparing the priorities
+  // with the order of the policy.
+  bool operator<(const basicHeapNode &other) const;
 
-  // Getter and setter for heap node reference.
-  rbNode *getrbNodeRef() const;
-  void setrbNodeRef(rbNode *newHeapNodeRef);
+  // Replaces the priority of the node.
+  void updateKey(keyType newKey);
 
-  // Overloaded output operator to print out the heap node.
-  friend std::ostream &operator<<(std::ostream &os, const heapNode &node);
+  // Getter and setter for heap node reference.
+  Node *getrbNodeRef() const;
+  void setrbNodeRef(Node *newHeapNodeRef);
 };
 
-#endif // HEAPNODE_H
\ No newline at end of file
+/**
+ * @brief Constructor for heapNode class.
+ *
+ * @param key The priority of the ride.
+ */
+template <typename Node, typename Priority>
+basicHeapNode<Node, Priority>::basicHeapNode(keyType key)
+    : key(key), rbNodeRef(nullptr) {}
+
+/**
+ * @brief Destructor for heapNode class.
+ */
+template <typename Node, typename Priority>
+basicHeapNode<Node, Priority>::~basicHeapNode() {}
+
+/**
+ * @brief Comparison operator for heapNode class.
+ *
+ * @param other The other heapNode to compare against.
+ * @return True if this heapNode is less than the other heapNode, false
+ * otherwise.
+ */
+template <typename Node, typename Priority>
+bool basicHeapNode<Node, Priority>::operator<(
+    const basicHeapNode &other) const {
+  return Priority::less(key, other.key);
+}
+
+/**
+ * @brief Replaces the priority of the heap node.
+ *
+ * @param newKey The new priority.
+ */
+template <typename Node, typename Priority>
+void basicHeapNode<Node, Priority>::updateKey(keyType newKey) {
+  key = newKey;
+}
+
+/**
+ * @brief Getter for the red-black tree node reference.
+ *
+ * @return A pointer to the red-black tree node reference.
+ */
+template <typename Node, typename Priority>
+Node *basicHeapNode<Node, Priority>::getrbNodeRef() const {
+  return rbNodeRef;
+}
+
+/**
+ * @brief Setter for the red-black tree node reference.
+ *
+ * @param newHeapNodeRef Pointer to a red-black tree node reference.
+ */
+template <typename Node, typename Priority>
+void basicHeapNode<Node, Priority>::setrbNodeRef(Node *newHeapNodeRef) {
+  rbNodeRef = newHeapNodeRef;
+}
+
+/**
+ * @brief Overloaded stream insertion operator for heapNode class.
+ * The ride is read from the linked red-black node.
+ *
+ * @param os The output stream.
+ * @param node The heapNode object to insert into the stream.
+ * @return A reference to the output stream.
+ */
+template <typename Node, typename Priority>
+std::ostream &operator<<(std::ostream &os,
+                         const basicHeapNode<Node, Priority> &node) {
+  return os << *node.getrbNodeRef();
+}
+
+#endif // HEAPNODE_H
@@ -0,0 +1,90 @@
+#include "ingestEngine.hpp"
+#include "minHeap.hpp"
+#include "packedHeap.hpp"
+#include "pairingHeap.hpp"
+
+/**
+ * @brief Waits until the applier has delivered the result of the command.
+ *
+ * @return The result of the command.
+ */
+const commandResult &completionSlot::wait() {
+  while (!ready.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  return result;
+}
+
+/**
+ * @brief Constructor for the ingest engine, which starts the applier thread.
+ *
+ * @param capacity The minimum number of commands the ring holds.
+ */
+template <typename Heap>
+ingestEngine<Heap>::ingestEngine(std::size_t capacity)
+    : ring(capacity), stopping(false) {
+  applier = std::thread(&ingestEngine::applyLoop, this);
+}
+
+/**
+ * @brief Destructor for the ingest engine. The applier executes the commands
+ * still in the ring before it stops.
+ */
+template <typename Heap> ingestEngine<Heap>::~ingestEngine() {
+  stopping.store(true, std::memory_order_release);
+  applier.join();
+}
+
+/**
+ * @brief Queues a command for the applier thread.
+ *
+ * @param cmd The command to execute.
+ * @param slot The slot receiving the result, which must not be in use.
+ */
+template <typename Heap>
+void ingestEngine<Heap>::submit(const command &cmd, completionSlot &slot) {
+  slot.ready.store(false, std::memory_order_relaxed);
+
+  while (!ring.tryPush({cmd, &slot})) {
+    std::this_thread::yield();
+  }
+}
+
+/**
+ * @brief Takes commands from the ring in batches, executes them and delivers
+ * their results, until the engine stops and the ring is empty.
+ */
+template <typename Heap> void ingestEngine<Heap>::applyLoop() {
+  ingestRequest batch[applyBatch];
+
+  while (true) {
+    int count = 0;
+    while (count < applyBatch && ring.tryPop(batch[count])) {
+      count++;
+    }
+
+    if (count == 0) {
+      // Commands pushed before stopping was set are visible by now, so an
+      // empty ring after seeing the flag really is the end.
+      if (stopping.load(std::memory_order_acquire)) {
+        if (!ring.tryPop(batch[0])) {
+          return;
+        }
+        count = 1;
+      } else {
+        std::this_thread::yield();
+        continue;
+      }
+    }
+
+    for (int i = 0; i < count; i++) {
+      applyCommand(store, batch[i].cmd, batch[i].slot->result);
+      batch[i].slot->ready.store(true, std::memory_order_release);
+    }
+  }
+}
+
+// Heaps available to the rest of the program.
+template class ingestEngine<minHeap<4>>;
+template class ingestEngine<packedHeap<8>>;
+template class ingestEngine<pairingHeap>;
@@ -0,0 +1,63 @@
+#ifndef INGESTENGINE_H
+#define INGESTENGINE_H
+
+#include "commandParser.hpp"
+#include "commandResult.hpp"
+#include "mpscRing.hpp"
+#include "rideStore.hpp"
+#include <atomic>
+#include <thread>
+
+// Place where the applier thread leaves the result of a command for the
+// producer that submitted it. Each producer owns its slots and reuses a slot
+// once it has read the result.
+struct completionSlot {
+  std::atomic<bool> ready{false};
+  commandResult result;
+
+  // Waits until the result is ready and returns it.
+  const commandResult &wait();
+};
+
+// A command waiting in the ring, with the slot its result goes to.
+struct ingestRequest {
+  command cmd;
+  completionSlot *slot;
+};
+
+// Runs all commands on one applier thread that owns the rides, so the tree
+// and heap need no locks. Producer threads hand their commands over through a
+// lock-free ring and pick the results up from their completion slots. The
+// applier drains the ring in batches and executes each batch back to back,
+// keeping the rides hot in its cache.
+template <typename Heap> class ingestEngine {
+private:
+  // Largest number of commands the applier takes from the ring at once.
+  static constexpr int applyBatch = 64;
+
+  mpscRing<ingestRequest> ring;
+  rideStore<Heap> store;
+  std::atomic<bool> stopping;
+  std::thread applier;
+
+  // The loop of the applier thread.
+  void applyLoop();
+
+public:
+  // Creates the ring with at least the given capacity and starts the applier.
+  explicit ingestEngine(std::size_t capacity);
+
+  // Executes the commands still in the ring and stops the applier. All
+  // producers must have stopped submitting.
+  ~ingestEngine();
+
+  ingestEngine(const ingestEngine &) = delete;
+  ingestEngine &operator=(const ingestEngine &) = delete;
+
+  // Queues a command whose result is delivered to the given slot. Spins while
+  // the ring is full, but never takes a lock. Commands submitted by one
+  // thread are executed in submission order.
+  void submit(const command &cmd, completionSlot &slot);
+};
+
+#endif // INGESTENGINE_H
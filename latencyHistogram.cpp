@@ -0,0 +1,111 @@
+#include "latencyHistogram.hpp"
+
+/**
+ * @brief Constructor for latencyHistogram class.
+ */
+latencyHistogram::latencyHistogram() : counts(), total(0), maxValue(0) {}
+
+/**
+ * @brief Returns the bucket holding a value.
+ *
+ * @details Values below subBuckets get a bucket each. Larger values are
+ * bucketed by the position of their highest set bit and the subBucketBits
+ * bits that follow it.
+ *
+ * @param value The value to bucket.
+ * @return The index of the bucket.
+ */
+int latencyHistogram::getBucket(std::uint64_t value) {
+  if (value < subBuckets) {
+    return value;
+  }
+
+  int highestBit = 63 - __builtin_clzll(value);
+  int shift = highestBit - subBucketBits;
+  int subBucket = (value >> shift) & (subBuckets - 1);
+  return (shift + 1) * subBuckets + subBucket;
+}
+
+/**
+ * @brief Returns the largest value held by a bucket.
+ *
+ * @param bucket The index of the bucket.
+ * @return The upper limit of the bucket.
+ */
+std::uint64_t latencyHistogram::getBucketLimit(int bucket) {
+  if (bucket < subBuckets) {
+    return bucket;
+  }
+
+  int shift = bucket / subBuckets - 1;
+  std::uint64_t subBucket = bucket % subBuckets;
+  return ((subBuckets + subBucket + 1) << shift) - 1;
+}
+
+/**
+ * @brief Records one latency.
+ *
+ * @param nanoseconds The latency to record.
+ */
+void latencyHistogram::record(std::uint64_t nanoseconds) {
+  counts[getBucket(nanoseconds)]++;
+  total++;
+  if (nanoseconds > maxValue) {
+    maxValue = nanoseconds;
+  }
+}
+
+/**
+ * @brief Returns the latency below which the given fraction of the values
+ * fall, rounded up to the limit of its bucket.
+ *
+ * @param fraction The fraction of values, for example 0.99 for p99.
+ * @return The percentile in nanoseconds, 0 for an empty histogram.
+ */
+std::uint64_t latencyHistogram::getPercentile(double fraction) const {
+  std::uint64_t rank = fraction * total;
+  if (rank >= total) {
+    rank = total - 1;
+  }
+
+  std::uint64_t seen = 0;
+  for (int bucket = 0; bucket < bucketCount; bucket++) {
+    seen += counts[bucket];
+    if (seen > rank) {
+      std::uint64_t limit = getBucketLimit(bucket);
+      return limit < maxValue ? limit : maxValue;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Get the number of recorded values.
+ *
+ * @return The number of values.
+ */
+std::uint64_t latencyHistogram::getCount() const {
+  return total;
+}
+
+/**
+ * @brief Get the largest recorded value.
+ *
+ * @return The largest latency in nanoseconds.
+ */
+std::uint64_t latencyHistogram::getMax() const {
+  return maxValue;
+}
+
+/**
+ * @brief Prints a summary of the histogram on one line.
+ *
+ * @param os The output stream.
+ * @param name The name of the measured operation.
+ */
+void latencyHistogram::print(std::ostream &os, const char *name) const {
+  os << name << ": count=" << total << " p50=" << getPercentile(0.5)
+     << "ns p90=" << getPercentile(0.9) << "ns p99=" << getPercentile(0.99)
+     << "ns p99.9=" << getPercentile(0.999) << "ns max=" << maxValue
+     << "ns\n";
+}
@@ -0,0 +1,45 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <ostream>
+
+// Histogram of latencies in nanoseconds with logarithmic buckets. Every power
+// of two is split into subBuckets linear buckets, so a recorded value is off
+// by at most 1/subBuckets (12.5%) of itself. Recording is a few bit
+// operations and one increment, with no allocation.
+class latencyHistogram {
+private:
+  static const int subBucketBits = 3;
+  static const int subBuckets = 1 << subBucketBits;
+  static const int bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+  std::uint64_t counts[bucketCount]; // Number of values in every bucket.
+  std::uint64_t total;               // Number of recorded values.
+  std::uint64_t maxValue;            // Largest recorded value.
+
+  // Returns the bucket holding a value.
+  static int getBucket(std::uint64_t value);
+
+  // Returns the largest value held by a bucket.
+  static std::uint64_t getBucketLimit(int bucket);
+
+public:
+  // Constructor creates an empty histogram.
+  latencyHistogram();
+
+  // Records one latency.
+  void record(std::uint64_t nanoseconds);
+
+  // Returns the latency below which the given fraction of the values fall.
+  std::uint64_t getPercentile(double fraction) const;
+
+  // Getters for the number of values and the largest value.
+  std::uint64_t getCount() const;
+  std::uint64_t getMax() const;
+
+  // Prints the count, p50, p90, p99, p99.9 and max on one line.
+  void print(std::ostream &os, const char *name) const;
+};
+
+#endif // LATENCYHISTOGRAM_H
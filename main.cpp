@@ -1,194 +1,583 @@
+#include "binaryCommandReader.hpp"
+#include "binaryFormat.hpp"
+#include "commandParser.hpp"
+#include "commandResult.hpp"
+#include "dispatchEngine.hpp"
+#include "ingestEngine.hpp"
+#include "latencyHistogram.hpp"
 #include "minHeap.hpp"
-#include "rbTree.hpp"
-#include <fstream>
+#include "outputWriter.hpp"
+#include "packedHeap.hpp"
+#include "pairingHeap.hpp"
+#include "priorityQueue.hpp"
+#include "shardedDispatcher.hpp"
+#include "workStealingPool.hpp"
+#include "writeAheadLog.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <utility>
+#include <vector>
 
-minHeap myHeap;
-rbTree myTree;
+// Runs of consecutive inserts are loaded in pieces of at most this many
+// commands to bound the buffered commands.
+const std::size_t bulkInsertMaximum = 1 << 20;
 
-/**
-* @brief This function inserts the ride information into both the red black tree
-* and minheap.
-*
-* @param ridenumber, rideCost, tripDuration the ride information to be inserted
-* @param out The output file stream object to output if duplicate ridenumber is
-inserted
-*/
-void Insert(int rideNumber, int rideCost, int tripDuration,
-            std::ofstream &out) {
-  // Create a new red-black tree node with the given ride number, cost, and
-  // duration.
-  rbNode *rbnode = new rbNode(rideNumber, rideCost, tripDuration);
-  // Create a new heap node with the given ride number, cost, and duration.
-  heapNode heapnode = heapNode(rideNumber, rideCost, tripDuration);
+// Number of commands the reader may run ahead of the output with --ingest,
+// and the capacity of the ring feeding the applier thread.
+const std::size_t ingestWindow = 1024;
 
-  try {
-    // Insert the new red-black tree node into the red-black tree.
-    myTree.insert(rbnode);
+// Number of commands a zone executes in multi-city mode before it goes back
+// to the pool, so that idle workers can steal the zones waiting behind it.
+const std::size_t zoneSlice = 4096;
 
-    // Get the address of the new heap node in the heap.
-    heapNode *adr = myHeap.getAddress();
+// Latency of every command type, recorded only with --histogram.
+latencyHistogram latencies[commandTypeCount];
 
-    // Set the heap node reference of the red-black tree node to the address
-    // obtained above.
-    rbnode->setHeapNodeRef(adr);
-    // Set the red-black tree node reference of the heap node to the new
-    // red-black tree node.
-    heapnode.setrbNodeRef(rbnode);
+// Set by SIGUSR1 to request a dump of the latency histograms.
+volatile std::sig_atomic_t dumpRequested = 0;
 
-    // Insert the new heap node into the heap.
-    myHeap.insert(heapnode);
-  } catch (const std::exception &err) {
-    // If an exception is thrown during the insertion due to duplicate
-    // ridenNumber, print out the error message using the ofstream object.
-    out << err.what() << std::endl;
-    // Exit the program.
+// Set by SIGUSR2 to request a background snapshot of the rides to
+// snapshotFile, given with --snapshot. snapshotChild is the process writing
+// the last snapshot, or 0 if there is none.
+volatile std::sig_atomic_t snapshotRequested = 0;
+const char *snapshotFile = nullptr;
+pid_t snapshotChild = 0;
+
+// By default a group commit of the write-ahead log covers up to 256 records
+// or the records of one millisecond.
+const std::size_t defaultLogGroup = 256;
+const int defaultLogWindow = 1000;
+
+/**
+ * @brief Executes a single parsed command on an engine, with the result
+ * written to out. A failed insert ends the program.
+ *
+ * @param engine The engine holding the rides.
+ * @param cmd The command to execute.
+ * @param out The output writer the results are written to.
+ */
+void Execute(dispatchEngine &engine, const command &cmd, outputWriter &out) {
+  // Flush the pending output and exit after a duplicate ride number.
+  if (!engine.execute(cmd, out)) {
+    out.flush();
+    exit(1);
+  }
+}
+
+/**
+ * @brief Executes a run of consecutive inserts on an engine, loading long
+ * runs in bulk. A failed insert ends the program.
+ *
+ * @param engine The engine holding the rides.
+ * @param inserts The insert commands of the run, in input order.
+ * @param out The output writer to output if duplicate ridenumber is inserted
+ */
+void BulkInsert(dispatchEngine &engine, const std::vector<command> &inserts,
+                outputWriter &out) {
+  if (!engine.bulkInsert(inserts, out)) {
+    out.flush();
+    exit(1);
+  }
+}
+
+/**
+ * @brief Executes a single parsed command on a sharded dispatcher, with the
+ * same output as Execute.
+ *
+ * @param cmd The command to execute.
+ * @param dispatcher The sharded dispatcher holding the rides.
+ * @param out The output writer the results are written to.
+ */
+template <typename Heap>
+void ExecuteSharded(const command &cmd, shardedDispatcher<Heap> &dispatcher,
+                    outputWriter &out) {
+  commandResult result;
+  applyCommand(dispatcher, cmd, result);
+
+  // Flush the pending output and exit after a duplicate ride number.
+  if (!writeResult(cmd, result, out)) {
+    out.flush();
     exit(1);
   }
 }
 
 /**
-This function retrieves the next ride from a heap data structure, deletes it
-from the red black tree as well as the heap, and writes it to an output file
-stream object.
-@param out The output file stream object to which the next ride will be written.
-*/
-void GetNextRide(std::ofstream &out) {
+ * @brief Prints the latency histograms of all command types that ran.
+ */
+void DumpLatencies() {
+  for (int i = 0; i < commandTypeCount; i++) {
+    if (latencies[i].getCount() > 0) {
+      latencies[i].print(std::cerr,
+                         getCommandName(static_cast<commandType>(i + 1)));
+    }
+  }
+}
+
+/**
+ * @brief Signal handler requesting a dump of the latency histograms. The dump
+ * itself happens in the command loop, between two commands.
+ */
+void RequestLatencyDump(int) {
+  dumpRequested = 1;
+}
+
+/**
+ * @brief Signal handler requesting a snapshot. The snapshot itself is started
+ * in the command loop, between two commands.
+ */
+void RequestSnapshot(int) {
+  snapshotRequested = 1;
+}
+
+/**
+ * @brief Collects the process writing the last snapshot and reports if it
+ * failed.
+ *
+ * @param block Whether to wait for a snapshot that is still being written.
+ * @return True if no snapshot process is left, false if it is still running.
+ */
+bool ReapSnapshot(bool block) {
+  if (snapshotChild == 0) {
+    return true;
+  }
+
+  int status;
+  pid_t done = waitpid(snapshotChild, &status, block ? 0 : WNOHANG);
+  if (done == 0) {
+    return false;
+  }
+  if (done < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::cerr << "could not write snapshot " << snapshotFile << "\n";
+  }
+  snapshotChild = 0;
+  return true;
+}
+
+/**
+ * @brief Starts a background snapshot of the rides of an engine. If the
+ * previous snapshot is still being written, the request stays pending and is
+ * retried after the next command.
+ *
+ * @param engine The engine holding the rides.
+ */
+void StartSnapshot(dispatchEngine &engine) {
+  if (!ReapSnapshot(false)) {
+    return;
+  }
+
+  snapshotRequested = 0;
   try {
-    // Remove the minimum heap node from the heap.
-    heapNode nextRide = myHeap.removeMin();
-    myTree.deleteNode(nextRide.getrbNodeRef());
-    out << nextRide << std::endl;
+    snapshotChild = engine.startSnapshot(snapshotFile);
   } catch (const std::exception &err) {
-    out << err.what() << std::endl;
+    std::cerr << err.what() << "\n";
   }
 }
 
 /**
- * @brief Prints the details of the ride with given rideNumber
+ * @brief Replays a write-ahead log on top of the restored rides and opens it
+ * for appending.
  *
- * @param rideNumber The ride number to be printed
- * @param out The output stream to print the details to
- * If the ride is not found, "(0,0,0)" is printed.
+ * @details The records a restored snapshot already contains are skipped. The
+ * results of the replayed commands were delivered before the restart, so
+ * they are discarded. A record torn by a crash ends the replay and is cut off
+ * the log, since its command was never acknowledged.
+ *
+ * @param engine The engine the log is replayed on.
+ * @param fileName Path of the log, which is created if it does not exist.
+ * @param skip Number of records contained in the restored snapshot.
+ * @param groupRecords Number of records that complete a group commit.
+ * @param groupWindow Microseconds after which a group commit is complete.
+ * @return The log, positioned after its last intact record.
+ * @throws std::runtime_error If the log cannot be read or written, or ends
+ * before the records of the snapshot, or if it inserts a ride number twice.
  */
-void Print(int rideNumber, std::ofstream &out) {
-  rbNode *ride =
-      myTree.search(rideNumber); // Search for ridenumber node in red black tree
+std::unique_ptr<writeAheadLog> OpenLog(dispatchEngine &engine,
+                                       const char *fileName,
+                                       std::uint64_t skip,
+                                       std::size_t groupRecords,
+                                       int groupWindow) {
+  std::size_t validSize = 0;
+  std::uint64_t records = 0;
 
-  // if node not exist then write (0,0,0) otherwise the found ride
-  if (ride == nullptr) {
-    out << "(0,0,0)" << std::endl;
-  } else {
-    out << *ride << std::endl;
+  // A log shorter than its header is new or was cut off while created.
+  struct stat info;
+  if (stat(fileName, &info) == 0 && info.st_size >= binaryHeaderSize) {
+    binaryCommandReader reader(fileName);
+    outputWriter discard("/dev/null");
+    command cmd;
+
+    while (reader.next(cmd)) {
+      if (records++ >= skip && !engine.execute(cmd, discard)) {
+        throw std::runtime_error(std::string(fileName) +
+                                 " holds a ride number twice");
+      }
+    }
+    validSize = reader.getOffset();
+  }
+
+  if (records < skip) {
+    throw std::runtime_error(std::string(fileName) +
+                             " ends before the restored snapshot");
+  }
+
+  return std::unique_ptr<writeAheadLog>(
+      new writeAheadLog(fileName, validSize, records, groupRecords,
+                        std::chrono::microseconds(groupWindow)));
+}
+
+/**
+ * @brief Reads all commands from a reader and executes them.
+ *
+ * @details With Timed set, the latency of every command is recorded in the
+ * histogram of its type. Without it, the loop contains no instrumentation at
+ * all, so the histograms cost nothing unless they are enabled. With Batched
+ * set, runs of consecutive inserts are collected and loaded in bulk into the
+ * engine. Inserts produce no output unless they fail, so
+ * deferring them until the next other command does not change the output.
+ * Timed runs execute every insert on its own to keep the latencies per
+ * command.
+ *
+ * @param reader The text parser or binary reader supplying the commands.
+ * @param out The output writer the results are written to.
+ * @param execute Executes one command.
+ * @param engine The engine the commands run on, which takes the bulk loads
+ * and snapshots, or nullptr if they run on a sharded dispatcher.
+ */
+template <bool Timed, bool Batched, typename Reader, typename Executor>
+void Run(Reader &reader, outputWriter &out, Executor execute,
+         dispatchEngine *engine) {
+  command cmd;
+  std::vector<command> inserts;
+  while (reader.next(cmd)) {
+    if (Timed) {
+      auto start = std::chrono::steady_clock::now();
+      execute(cmd);
+      auto stop = std::chrono::steady_clock::now();
+
+      latencies[static_cast<int>(cmd.type) - 1].record(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+              .count());
+
+      if (dumpRequested) {
+        dumpRequested = 0;
+        DumpLatencies();
+      }
+    } else if (Batched && cmd.type == commandType::INSERT) {
+      inserts.push_back(cmd);
+      if (inserts.size() == bulkInsertMaximum) {
+        BulkInsert(*engine, inserts, out);
+        inserts.clear();
+      }
+    } else {
+      if (!inserts.empty()) {
+        BulkInsert(*engine, inserts, out);
+        inserts.clear();
+      }
+      execute(cmd);
+    }
+
+    // Snapshots are only requested when the rides are in an engine. Inserts
+    // still waiting for a bulk load have to be part of it.
+    if (snapshotRequested) {
+      if (!inserts.empty()) {
+        BulkInsert(*engine, inserts, out);
+        inserts.clear();
+      }
+      StartSnapshot(*engine);
+    }
+  }
+
+  if (!inserts.empty()) {
+    BulkInsert(*engine, inserts, out);
   }
 }
 
 /**
- * @brief Prints the details of all rides with ride numbers in the given range
+ * @brief Reads all commands from a reader and executes them on an applier
+ * thread.
+ *
+ * @details The reader thread submits every command to an ingest engine and
+ * writes the results in input order. Up to ingestWindow commands are in
+ * flight, each with its own completion slot, so reading and parsing overlap
+ * with executing. After a duplicate ride number the run stops, and the
+ * engine finishes the commands still in flight and joins its thread on the
+ * way out.
  *
- * @param rideNumber1 The start ride number of the range (inclusive)
- * @param rideNumber2 The end ride number of the range (inclusive)
- * @param out The output stream to print the details to
- * If no rides are found in the range, "(0,0,0)" is printed.
+ * @param reader The text parser or binary reader supplying the commands.
+ * @param out The output writer the results are written to.
+ * @return false if the run stopped at a duplicate ride number, true otherwise.
  */
-void Print(int rideNumber1, int rideNumer2, std::ofstream &out) {
-  std::vector<rbNode> res = myTree.searchInRange(
-      rideNumber1,
-      rideNumer2); // Search for ride nodes in red black tree within range
-
-  // if nodes do not exist then write (0,0,0) otherwise the found rides
-  if (res.empty()) {
-    out << "(0,0,0)" << std::endl;
+template <typename Heap, typename Reader>
+bool RunIngest(Reader &reader, outputWriter &out) {
+  // The slots outlive the engine, which delivers the results of the commands
+  // in flight when it is destroyed.
+  std::unique_ptr<completionSlot[]> slots(new completionSlot[ingestWindow]);
+  std::vector<command> pending(ingestWindow);
+  ingestEngine<Heap> engine(ingestWindow);
+  std::size_t submitted = 0, written = 0;
+
+  // Waits for the oldest command in flight and writes its result.
+  auto writeOldest = [&]() {
+    std::size_t index = written % ingestWindow;
+    if (!writeResult(pending[index], slots[index].wait(), out)) {
+      // Flush the pending output and stop after a duplicate ride number.
+      out.flush();
+      return false;
+    }
+    written++;
+    return true;
+  };
+
+  command cmd;
+  while (reader.next(cmd)) {
+    if (submitted - written == ingestWindow && !writeOldest()) {
+      return false;
+    }
+
+    std::size_t index = submitted % ingestWindow;
+    pending[index] = cmd;
+    engine.submit(cmd, slots[index]);
+    submitted++;
+  }
+
+  while (written < submitted) {
+    if (!writeOldest()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Reads all commands from a reader and executes them on a sharded
+ * dispatcher or an ingest engine whose shards hold their rides in the given
+ * heap.
+ *
+ * @param reader The text parser or binary reader supplying the commands.
+ * @param out The output writer the results are written to.
+ * @param timed Whether to record the latency of every command, which the
+ * options never request together with the ingest engine.
+ * @param shardCount The number of shards, or 0 for the ingest engine.
+ * @return false if the ingest engine stopped at a duplicate ride number,
+ * true otherwise.
+ */
+template <typename Heap, typename Reader>
+bool RunThreaded(Reader &reader, outputWriter &out, bool timed,
+                 int shardCount) {
+  if (shardCount == 0) {
+    return RunIngest<Heap>(reader, out);
+  }
+
+  shardedDispatcher<Heap> dispatcher(shardCount);
+  auto execute = [&](const command &cmd) {
+    ExecuteSharded(cmd, dispatcher, out);
+  };
+  if (timed) {
+    Run<true, false>(reader, out, execute, nullptr);
   } else {
-    for (int i = 0; i < res.size(); i++) {
-      out << res[i] << ", "[i == res.size() - 1];
+    Run<false, false>(reader, out, execute, nullptr);
+  }
+  return true;
+}
+
+// A service zone in multi-city mode, with its own input, engine and output.
+// Only one task at a time works on a zone.
+template <typename Reader> struct zone {
+  std::string name;
+  Reader reader;
+  dispatchEngine engine;
+  outputWriter out;
+  std::vector<command> inserts; // Inserts waiting for a bulk load.
+  bool failed;                  // Set when the zone stopped on an error.
+
+  zone(const std::string &name, const char *inputFile,
+       const std::string &outputFile, outputFormat format,
+       std::unique_ptr<priorityQueue> heap, bool lookup)
+      : name(name), reader(inputFile), engine(std::move(heap), lookup),
+        out(outputFile.c_str(), format), failed(false) {}
+};
+
+/**
+ * @brief Executes the next slice of the commands of a zone and submits the
+ * rest of them to the same worker.
+ *
+ * @details Runs of consecutive inserts are loaded in bulk like in Run, and a
+ * run may continue into the next slice. The zone stops after a duplicate ride
+ * number, like gatorTaxi does with a single input, without affecting the
+ * other zones.
+ *
+ * @param current The zone.
+ * @param pool The pool running the zones.
+ * @param worker The index of the worker running this slice.
+ */
+template <typename Reader>
+void RunZoneSlice(zone<Reader> &current, workStealingPool &pool, int worker) {
+  try {
+    command cmd;
+    for (std::size_t i = 0; i < zoneSlice; i++) {
+      bool ok = true;
+      if (!current.reader.next(cmd)) {
+        if (!current.inserts.empty()) {
+          ok = current.engine.bulkInsert(current.inserts, current.out);
+        }
+        current.failed = !ok;
+        current.out.flush();
+        return;
+      }
+
+      if (cmd.type == commandType::INSERT) {
+        current.inserts.push_back(cmd);
+        if (current.inserts.size() == bulkInsertMaximum) {
+          ok = current.engine.bulkInsert(current.inserts, current.out);
+          current.inserts.clear();
+        }
+      } else {
+        if (!current.inserts.empty()) {
+          ok = current.engine.bulkInsert(current.inserts, current.out);
+          current.inserts.clear();
+        }
+        ok = ok && current.engine.execute(cmd, current.out);
+      }
+
+      if (!ok) {
+        current.failed = true;
+        current.out.flush();
+        return;
+      }
     }
-    out << std::endl;
+  } catch (const std::exception &err) {
+    std::cerr << "Error: zone " << current.name << ": " << err.what() << "\n";
+    current.failed = true;
+    return;
   }
+
+  pool.submit([&current, &pool](int next) {
+    RunZoneSlice(current, pool, next);
+  }, worker);
 }
 
 /**
- * @brief Cancels the ride with given ride number
+ * @brief Runs every zone on its own engine, all of them on one
+ * work-stealing pool.
+ *
+ * @details Every zone starts as one task and goes back to the pool after
+ * each slice of its commands. The continuation stays on the deque of the
+ * same worker, where the engine is still in the cache, unless an idle worker
+ * steals it. Each zone writes output_file_<zone>.txt, or .bin with binary
+ * output.
  *
- * @param rideNumber The ride number to be cancelled
- * Removes the ride from the red-black tree and the heap.
+ * @param zoneInputs The pairs of zone name and input file.
+ * @param threads The number of worker threads.
+ * @param binaryOutput Whether to write binary results.
+ * @param heapName The name of the heap backend.
+ * @param lookup Whether the engines find rides in a lookup table.
+ * @return True if every zone ran to the end of its input.
  */
-void CancelRide(int rideNumber) {
-  rbNode *ride = myTree.search(
-      rideNumber); // Search for node with the ridenumber in red black tree
+template <typename Reader>
+bool RunZones(const std::vector<std::pair<std::string, const char *>>
+                  &zoneInputs,
+              int threads, bool binaryOutput, const std::string &heapName,
+              bool lookup) {
+  std::vector<std::unique_ptr<zone<Reader>>> zones;
+  for (const auto &input : zoneInputs) {
+    zones.emplace_back(new zone<Reader>(
+        input.first, input.second,
+        "output_file_" + input.first + (binaryOutput ? ".bin" : ".txt"),
+        binaryOutput ? outputFormat::BINARY : outputFormat::TEXT,
+        makePriorityQueue(heapName), lookup));
+  }
+
+  {
+    // More workers than zones would have nothing to do
+    workStealingPool pool(std::min<int>(threads, zones.size()));
+    for (auto &current : zones) {
+      zone<Reader> *started = current.get();
+      pool.submit([started, &pool](int worker) {
+        RunZoneSlice(*started, pool, worker);
+      });
+    }
+    pool.wait();
+  }
 
-  // check if node exist
-  if (ride != nullptr) {
-    int idx = ride->getHeapNodeRef()->pos;
-    myTree.deleteNode(ride); // Delete node from red black tree
-    myHeap.remove(idx);      // Delete node from heap
+  bool complete = true;
+  for (const auto &current : zones) {
+    complete = complete && !current->failed;
   }
+  return complete;
 }
 
 /**
- * @brief Updates the trip duration of a ride if the new duration is not more
- * than twice the current duration
+ * @brief Checks that a zone name can be part of a file name: letters, digits,
+ * '-' and '_' only.
  *
- * @param rideNumber The ride number of the ride to be updated
- * @param newTripDuration The new trip duration to be updated to
- * Removes the ride from the red-black tree and the heap, and reinserts the ride
- * with updated duration If the new trip duration is less than or equal to the
- * current duration, rideCost remains the same. If the new trip duration is more
- * than the current duration and less than twice its current duration, rideCost
- * increases by 10.
+ * @param name The zone name.
+ * @return True if the name is valid.
  */
-void UpdateTrip(int rideNumber, int newTripDuration) {
-  rbNode *ride = myTree.search(rideNumber);
-  if (ride != nullptr) {
-    // Remove ride from both the red black tree and min heap.
-    int idx = ride->getHeapNodeRef()->pos;
-    myTree.deleteNode(ride);
-    myHeap.remove(idx);
-
-    // if new trip duration is lesser than twice of previous tripduration then
-    // insert new ride
-    int currTripDuration = ride->tripDuration;
-    if (newTripDuration <= 2 * currTripDuration) {
-      // find ridecost for new ride, it will be same if then no change otherwise
-      // add 10 to previous value
-      int rideCost =
-          ride->rideCost + (newTripDuration <= currTripDuration ? 0 : 10);
-      rbNode *rbnode = new rbNode(rideNumber, rideCost, newTripDuration);
-      heapNode heapnode = heapNode(rideNumber, rideCost, newTripDuration);
-
-      myTree.insert(rbnode); // Insert into the red black tree.
-
-      heapNode *adr = myHeap.getAddress(); // Get the address of the new heap
-                                           // node in the heap.
-
-      rbnode->setHeapNodeRef(adr);   // Set the heap node reference of the
-                                     // red-black tree node to the address
-                                     // obtained above.
-      heapnode.setrbNodeRef(rbnode); // Set the red-black tree node reference of
-                                     // the heap node to the new
-                                     // red-black tree node.
-      myHeap.insert(heapnode);       // Insert the new heap node into the heap.
+bool ValidZoneName(const std::string &name) {
+  if (name.empty()) {
+    return false;
+  }
+  for (char c : name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' &&
+        c != '_') {
+      return false;
     }
   }
+  return true;
 }
 
 /**
- * @brief A utility function to separate information from given string.
+ * @brief Reads all commands from a reader and executes them, with or without
+ * latency histograms, on an engine, on a sharded dispatcher or on an ingest
+ * engine.
  *
- * @param s The string to be processes.
+ * @details The heap of the engine is chosen at runtime behind the
+ * priorityQueue interface. The sharded dispatcher and the ingest engine take
+ * their heap as a template argument instead, so each backend has its own
+ * instantiation and the name picks one of them here.
+ *
+ * @param reader The text parser or binary reader supplying the commands.
+ * @param out The output writer the results are written to.
+ * @param timed Whether to record the latency of every command.
+ * @param shardCount The number of shards, or 0 for no sharded dispatcher.
+ * @param ingest Whether to execute the commands on an ingest engine.
+ * @param heapName The name of the heap backend.
+ * @param engine The engine the commands run on without shards or ingest.
+ * @return false if the ingest engine stopped at a duplicate ride number,
+ * true otherwise.
  */
-std::vector<std::string> process_string(std::string s) {
-  std::vector<std::string> vec = {""};
-  for (char &c : s) {
-    if (c == '(' || c == ',' || c == ')') {
-      vec.emplace_back("");
+template <typename Reader>
+bool Run(Reader &reader, outputWriter &out, bool timed, int shardCount,
+         bool ingest, const std::string &heapName, dispatchEngine &engine) {
+  if (shardCount > 0 || ingest) {
+    // The ingest engine takes precedence over the shards
+    int shards = ingest ? 0 : shardCount;
+    if (heapName == "packed") {
+      return RunThreaded<packedHeap<8>>(reader, out, timed, shards);
+    } else if (heapName == "pairing") {
+      return RunThreaded<pairingHeap>(reader, out, timed, shards);
     } else {
-      vec.back() += c;
+      return RunThreaded<minHeap<4>>(reader, out, timed, shards);
     }
   }
-  vec.pop_back();
-  return vec;
+
+  auto execute = [&](const command &cmd) { Execute(engine, cmd, out); };
+  if (timed) {
+    Run<true, false>(reader, out, execute, &engine);
+  } else {
+    Run<false, true>(reader, out, execute, &engine);
+  }
+  return true;
 }
 
 /**
@@ -200,57 +589,218 @@ std::vector<std::string> process_string(std::string s) {
  * @return 0 if the program exits successfully, 1 otherwise
  */
 int main(int argc, char *argv[]) {
-  // Check that the program is called with an input file argument
-  if (argc != 2) {
-    std::cerr << "Usage: " << argv[0] << " input_file_name\n";
-    return 1;
+  bool binaryInput = false, binaryOutput = false, histogram = false;
+  bool ingest = false, lookup = false;
+  int shardCount = 0, logGroup = defaultLogGroup, logWindow = defaultLogWindow;
+  const char *inputFile = nullptr, *restoreFile = nullptr;
+  const char *logFile = nullptr;
+  std::string heapName = priorityQueueNames[0];
+  std::vector<std::pair<std::string, const char *>> zoneInputs;
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+
+  // Parse the options and the input file argument
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--binary") {
+      binaryInput = true;
+    } else if (arg == "--binary-output") {
+      binaryOutput = true;
+    } else if (arg == "--histogram") {
+      histogram = true;
+    } else if (arg == "--heap" && i + 1 < argc) {
+      heapName = argv[++i];
+    } else if (arg == "--ingest") {
+      ingest = true;
+    } else if (arg == "--lookup") {
+      lookup = true;
+    } else if (arg == "--shards" && i + 1 < argc) {
+      shardCount = std::atoi(argv[++i]);
+    } else if (arg == "--snapshot" && i + 1 < argc) {
+      snapshotFile = argv[++i];
+    } else if (arg == "--restore" && i + 1 < argc) {
+      restoreFile = argv[++i];
+    } else if (arg == "--log" && i + 1 < argc) {
+      logFile = argv[++i];
+    } else if (arg == "--log-group" && i + 1 < argc) {
+      logGroup = std::atoi(argv[++i]);
+    } else if (arg == "--log-window" && i + 1 < argc) {
+      logWindow = std::atoi(argv[++i]);
+    } else if (arg == "--zone" && i + 2 < argc) {
+      zoneInputs.emplace_back(argv[i + 1], argv[i + 2]);
+      i += 2;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+    } else if (inputFile == nullptr && arg.compare(0, 2, "--") != 0) {
+      inputFile = argv[i];
+    } else {
+      inputFile = nullptr;
+      zoneInputs.clear();
+      break;
+    }
   }
 
-  // Open the input file for reading
-  std::ifstream inFile(argv[1]);
-  if (!inFile) {
-    // Print an error message if the input file cannot be opened
-    std::cout << "Error: could not open file " << argv[1] << std::endl;
-    return 1;
+  // Snapshots, the log and the lookup cover the engine, which the
+  // sharded dispatcher and the ingest engine do not use. The ingest engine
+  // runs the commands on another thread, so it cannot time them either.
+  if ((snapshotFile != nullptr || restoreFile != nullptr ||
+       logFile != nullptr || lookup) &&
+      (shardCount > 0 || ingest)) {
+    inputFile = nullptr;
+  }
+  if (histogram && ingest) {
+    inputFile = nullptr;
+  }
+  if (logGroup < 1 || logWindow < 0) {
+    inputFile = nullptr;
+  }
+
+  // Zones take the place of the input file. Each zone has one engine and
+  // nothing else, and names an output file of its own.
+  if (!zoneInputs.empty()) {
+    bool valid = inputFile == nullptr && threads >= 1 && !histogram &&
+                 shardCount == 0 && !ingest && snapshotFile == nullptr &&
+                 restoreFile == nullptr && logFile == nullptr;
+    for (std::size_t i = 0; i < zoneInputs.size(); i++) {
+      valid = valid && ValidZoneName(zoneInputs[i].first);
+      for (std::size_t j = 0; j < i; j++) {
+        valid = valid && zoneInputs[i].first != zoneInputs[j].first;
+      }
+    }
+    if (!valid) {
+      inputFile = nullptr;
+      zoneInputs.clear();
+    }
+  }
+
+  // Create the heap of the engine, which also checks the name of the backend
+  std::unique_ptr<priorityQueue> heap = makePriorityQueue(heapName);
+  if (!heap) {
+    inputFile = nullptr;
+    zoneInputs.clear();
   }
 
-  // Open the output file for writing
-  std::ofstream outFile("output_file.txt");
-  if (!outFile) {
-    // Print an error message if the output file cannot be opened
-    std::cout << "Error: could not open file " << argv[1] << std::endl;
+  // Check that the program is called with an input file argument or zones
+  if (inputFile == nullptr && zoneInputs.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--binary] [--binary-output] [--histogram] "
+                 "[--heap minheap|packed|pairing] "
+                 "[--shards N | --ingest | [--lookup] [--snapshot FILE] "
+                 "[--restore FILE] "
+                 "[--log FILE [--log-group N] [--log-window US]]] "
+                 "input_file_name\n"
+              << "       " << argv[0]
+              << " [--binary] [--binary-output] "
+                 "[--heap minheap|packed|pairing] [--lookup] [--threads N] "
+                 "--zone NAME FILE [--zone NAME FILE ...]\n"
+              << "  --binary         the input is a binary command log\n"
+              << "  --binary-output  write binary results to "
+                 "output_file.bin\n"
+              << "  --histogram      print command latencies on exit or "
+                 "SIGUSR1, not with --ingest\n"
+              << "  --heap NAME      priority queue of the rides "
+                 "(default minheap)\n"
+              << "  --shards N       keep the rides in N shards with their "
+                 "own locks\n"
+              << "  --ingest         execute the commands on a separate "
+                 "applier thread\n"
+              << "  --lookup         find rides by ride number in a hash "
+                 "table\n"
+              << "  --snapshot FILE  write the rides to FILE on SIGUSR2 and "
+                 "at the end\n"
+              << "  --restore FILE   start with the rides of the snapshot "
+                 "FILE\n"
+              << "  --log FILE       replay the write-ahead log FILE and "
+                 "append to it\n"
+              << "  --log-group N    commit the log every N records "
+                 "(default 256)\n"
+              << "  --log-window US  or when a record waited US "
+                 "microseconds (default 1000)\n"
+              << "  --zone NAME FILE run the commands of FILE for zone NAME, "
+                 "writing output_file_NAME.txt\n"
+              << "  --threads N      worker threads of the zones (default "
+                 "all cores)\n";
     return 1;
   }
 
-  // Read from file line by line.
-  std::string data;
-  while (std::getline(inFile, data)) {
-    // Split the input line into a vector of strings
-    std::vector<std::string> command = process_string(data);
-
-    // Determine which command to execute based on the first word in the
-    // vector
-    if (command.front() == "Insert") {
-      Insert(std::stoi(command[1]), std::stoi(command[2]),
-             std::stoi(command[3]), outFile);
-    } else if (command.front() == "GetNextRide") {
-      GetNextRide(outFile);
-    } else if (command.front() == "Print") {
-      if (command.size() == 2) {
-        Print(std::stoi(command[1]), outFile);
-      } else {
-        Print(std::stoi(command[1]), std::stoi(command[2]), outFile);
-      }
-    } else if (command.front() == "UpdateTrip") {
-      UpdateTrip(std::stoi(command[1]), std::stoi(command[2]));
-    } else if (command.front() == "CancelRide") {
-      CancelRide(std::stoi(command[1]));
+  // Run every zone on its own engine in parallel
+  if (!zoneInputs.empty()) {
+    try {
+      bool complete =
+          binaryInput ? RunZones<binaryCommandReader>(zoneInputs, threads,
+                                                      binaryOutput, heapName,
+                                                      lookup)
+                      : RunZones<commandParser>(zoneInputs, threads,
+                                                binaryOutput, heapName, lookup);
+      return complete ? 0 : 1;
+    } catch (const std::exception &err) {
+      // Print an error message if a file cannot be opened
+      std::cout << "Error: " << err.what() << std::endl;
+      return 1;
     }
   }
 
-  // Close the input and output files
-  inFile.close();
-  outFile.close();
+  // Dump the latency histograms on exit, including the exit after a
+  // duplicate ride number, and whenever SIGUSR1 arrives.
+  if (histogram) {
+    std::atexit(DumpLatencies);
+    std::signal(SIGUSR1, RequestLatencyDump);
+  }
+
+  // Take a background snapshot whenever SIGUSR2 arrives.
+  if (snapshotFile != nullptr) {
+    std::signal(SIGUSR2, RequestSnapshot);
+  }
+
+  dispatchEngine engine(std::move(heap), lookup);
+
+  try {
+    // Start from the rides of a snapshot if requested
+    std::uint64_t logPosition = 0;
+    if (restoreFile != nullptr) {
+      logPosition = engine.restoreSnapshot(restoreFile);
+    }
+
+    // Recover the commands logged after the snapshot and log the new ones
+    std::unique_ptr<writeAheadLog> log;
+    if (logFile != nullptr) {
+      log = OpenLog(engine, logFile, logPosition, logGroup, logWindow);
+      engine.setLog(log.get());
+    }
+
+    // Open the output file for writing. No result is written before the
+    // commands up to it are committed to the log.
+    outputWriter outFile(binaryOutput ? "output_file.bin" : "output_file.txt",
+                         binaryOutput ? outputFormat::BINARY
+                                      : outputFormat::TEXT);
+    if (log) {
+      outFile.setBarrier([&log]() { log->commit(); });
+    }
+
+    // Read the input file command by command and execute each one.
+    bool complete;
+    if (binaryInput) {
+      binaryCommandReader reader(inputFile);
+      complete = Run(reader, outFile, histogram, shardCount, ingest,
+                     heapName, engine);
+    } else {
+      commandParser parser(inputFile);
+      complete = Run(parser, outFile, histogram, shardCount, ingest,
+                     heapName, engine);
+    }
+    if (!complete) {
+      return 1;
+    }
+
+    // Wait for a background snapshot and save the final rides
+    if (snapshotFile != nullptr) {
+      ReapSnapshot(true);
+      engine.writeSnapshot(snapshotFile);
+    }
+  } catch (const std::exception &err) {
+    // Print an error message if a file cannot be opened
+    std::cout << "Error: " << err.what() << std::endl;
+    return 1;
+  }
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,76 @@
+#include "mappedFile.hpp"
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructor for mappedFile class.
+ *
+ * @param fileName Path of the file to map.
+ * @throws std::runtime_error If the file cannot be opened or mapped.
+ */
+mappedFile::mappedFile(const char *fileName) : data(nullptr), length(0) {
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("could not open file ") + fileName);
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw std::runtime_error(std::string("could not open file ") + fileName);
+  }
+
+  length = info.st_size;
+  if (length > 0) {
+    void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error(std::string("could not map file ") + fileName);
+    }
+    data = static_cast<const char *>(mapping);
+    madvise(mapping, length, MADV_SEQUENTIAL);
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+}
+
+/**
+ * @brief Destructor for mappedFile class.
+ */
+mappedFile::~mappedFile() {
+  if (data != nullptr) {
+    munmap(const_cast<char *>(data), length);
+  }
+}
+
+/**
+ * @brief Get the first byte of the file.
+ *
+ * @return const char* Pointer to the start of the mapping.
+ */
+const char *mappedFile::begin() const {
+  return data;
+}
+
+/**
+ * @brief Get the end of the file.
+ *
+ * @return const char* Pointer one past the last byte of the mapping.
+ */
+const char *mappedFile::end() const {
+  return data + length;
+}
+
+/**
+ * @brief Get the size of the file.
+ *
+ * @return std::size_t The number of bytes in the file.
+ */
+std::size_t mappedFile::size() const {
+  return length;
+}
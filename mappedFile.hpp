@@ -0,0 +1,27 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+// A file mapped read-only into memory for sequential reading.
+class mappedFile {
+private:
+  const char *data;   // Start of the mapping, nullptr for an empty file.
+  std::size_t length; // Length of the file in bytes.
+
+public:
+  // Constructor maps the given file, destructor unmaps it.
+  // Throws std::runtime_error if the file cannot be opened or mapped.
+  explicit mappedFile(const char *fileName);
+  ~mappedFile();
+
+  mappedFile(const mappedFile &) = delete;
+  mappedFile &operator=(const mappedFile &) = delete;
+
+  // Getters for the mapped bytes.
+  const char *begin() const;
+  const char *end() const;
+  std::size_t size() const;
+};
+
+#endif // MAPPEDFILE_H
@@ -1,16 +1,16 @@
 #include "minHeap.hpp"
-#include "rbNode.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 /**
  * @brief Constructor for the min-heap.
  *
- * @details Initializes the heap vector with an initial capacity of 2005 and
- * sets the first element to a dummy node.
+ * @details Fills the slots in front of the root with dummy nodes. The vector
+ * grows on demand, so there is no upper bound on the number of rides.
  */
-minHeap::minHeap() {
-  heap.reserve(2005);
-  heap.front() = heapNode(-1, -1, -1);
+template <int Arity, typename Node, typename Priority>
+minHeap<Arity, Node, Priority>::minHeap() {
+  heap.assign(root, heapNode(typename Priority::keyType()));
 }
 
 /**
@@ -19,15 +19,27 @@ minHeap::minHeap() {
  * @details Does not perform any special cleanup because the heap vector is
  * destroyed automatically when the object is destroyed.
  */
-minHeap::~minHeap() {}
+template <int Arity, typename Node, typename Priority>
+minHeap<Arity, Node, Priority>::~minHeap() {}
 
 /**
  * @brief Checks if the min-heap is empty.
  *
  * @return True if the heap contains no elements, false otherwise.
  */
-bool minHeap::isEmpty() {
-  return size <= 1;
+template <int Arity, typename Node, typename Priority>
+bool minHeap<Arity, Node, Priority>::isEmpty() {
+  return heap.size() <= root;
+}
+
+/**
+ * @brief Returns the number of elements stored in the min-heap.
+ *
+ * @return The number of elements, not counting the dummy nodes.
+ */
+template <int Arity, typename Node, typename Priority>
+int minHeap<Arity, Node, Priority>::getSize() const {
+  return heap.size() - root;
 }
 
 /**
@@ -36,164 +48,285 @@ bool minHeap::isEmpty() {
  * @param index The index of the child node.
  * @return The index of the parent node.
  */
-int minHeap::getParent(int index) {
-  return index / 2;
+template <int Arity, typename Node, typename Priority>
+int minHeap<Arity, Node, Priority>::getParent(int index) {
+  return index / Arity + root - 1;
 }
 
 /**
- * @brief Calculates the index of the left child of a given index in the
- * min-heap.
+ * @brief Calculates the index of the first child of a given index in the
+ * min-heap. The remaining children follow it directly.
  *
  * @param index The index of the parent node.
- * @return The index of the left child node.
+ * @return The index of the first child node.
  */
-int minHeap::getLeftChild(int index) {
-  return 2 * index;
+template <int Arity, typename Node, typename Priority>
+int minHeap<Arity, Node, Priority>::getFirstChild(int index) {
+  return Arity * (index - root + 1);
 }
 
 /**
- * @brief Calculates the index of the right child of a given index in the
- * min-heap.
+ * @brief Starts loading the grandchildren of a node into the cache.
  *
- * @param index The index of the parent node.
- * @return The index of the right child node.
+ * @details The grandchildren of a node are the children of its sibling
+ * group, which lie next to each other in the heap. Sifting down compares them
+ * right after the children, so their loads overlap with the comparisons of
+ * the current level instead of stalling the next one.
+ *
+ * @param firstChild The index of the first child of the node.
  */
-int minHeap::getRightChild(int index) {
-  return 2 * index + 1;
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::prefetchGrandchildren(int firstChild) {
+  int first = getFirstChild(firstChild);
+  int last = std::min<int>(first + Arity * Arity, heap.size());
+  constexpr int perLine = std::max<int>(cacheLineSize / sizeof(heapNode), 1);
+
+  for (int index = first; index < last; index += perLine) {
+    __builtin_prefetch(&heap[index]);
+  }
 }
 
 /**
- * @brief Checks if a given index is valid for the current heap.
+ * @brief Restores the min-heap property by moving a hole up from the given
+ * position while the parent is greater than the moving element.
  *
- * @param index The index to check.
- * @return True if the index is valid, false otherwise.
+ * @details Each parent on the way is copied down into the hole once, and the
+ * moving element is only written when its final position is known, instead
+ * of swapping it with every parent.
+ *
+ * @param hole The index of the hole, which the moving element came from.
+ * @param moving The element to place.
  */
-bool minHeap::isValidIndex(int index) {
-  return index >= 1 && index < size;
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::heapifyUp(int hole, heapNode moving) {
+  while (hole > root) {
+    int parent = getParent(hole);
+    if (!(moving < heap[parent])) {
+      break;
+    }
+
+    // Move the parent down into the hole
+    heap[hole] = heap[parent];
+    heap[hole].getrbNodeRef()->setHeapHandle(hole);
+    hole = parent;
+  }
+
+  heap[hole] = moving;
+  moving.getrbNodeRef()->setHeapHandle(hole);
 }
 
 /**
- * @brief Swaps the positions of two nodes in the heap and updates their
- * references in the red black tree.
+ * @brief Inserts the ride of a red black node into the min-heap, links the
+ * red black node and the new heap node, and restores the heap property.
  *
- * @param index1 The index of the first node.
- * @param index2 The index of the second node.
+ * @param ride The red black node holding the ride to insert into the heap.
  */
-void minHeap::swap(int index1, int index2) {
-  // Find red black node reference for both indexes.
-  rbNode *rb1 = heap[index1].getrbNodeRef();
-  rbNode *rb2 = heap[index2].getrbNodeRef();
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::insert(Node *ride) {
+  heapNode moving(Priority::key(*ride));
+  moving.setrbNodeRef(ride);
 
-  // Interchange the red black tree reference
-  rb1->setHeapNodeRef(&heap[index2]);
-  rb2->setHeapNodeRef(&heap[index1]);
+  // The new slot is the hole the ride starts from.
+  heap.push_back(moving);
+  heapifyUp(heap.size() - 1, moving);
+}
+
+/**
+ * @brief Inserts the rides held by many red black nodes into the heap.
+ *
+ * @details The heap nodes are appended in any order and the heap property is
+ * then restored with Floyd's method, heapifying down every parent from the
+ * last one up to the root. This takes linear time in the size of the heap,
+ * rather than O(m log n) for inserting the rides one at a time.
+ *
+ * @param rides The red black nodes holding the rides to insert.
+ */
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::bulkInsert(
+    const std::vector<Node *> &rides) {
+  if (rides.empty()) {
+    return;
+  }
 
-  // Create a temporary heap node to be used to swap nodes.
-  heapNode temp = heap[index1];
+  heap.reserve(heap.size() + rides.size());
+  for (Node *ride : rides) {
+    int position = heap.size();
 
-  heap[index1] = heap[index2];
-  heap[index2] = temp;
+    heap.emplace_back(Priority::key(*ride));
+    heap[position].setrbNodeRef(ride);
+    ride->setHeapHandle(position);
+  }
 
-  // Change the pos of both nodes to newer indexes.
-  heap[index1].pos = index1;
-  heap[index2].pos = index2;
+  for (int position = getParent(heap.size() - 1); position >= root;
+       position--) {
+    heapifyDown(position, heap[position]);
+  }
 }
 
 /**
- * @brief Restores the min-heap property by recursively swapping a node with its
- * parent until the heap property is restored.
+ * @brief Restores the heap property by moving a hole down from the given
+ * position while its minimum child is smaller than the moving element.
  *
- * @param position The index of the node to heapify up from.
+ * @details As in heapifyUp, every child on the way is copied up into the hole
+ * once and the moving element is written last. In heaps too large for the
+ * cache the grandchildren are prefetched one level ahead.
+ *
+ * @param hole The index of the hole.
+ * @param moving The element to place.
  */
-void minHeap::heapifyUp(int position) {
-  if (heap[position] < heap[getParent(position)]) {
-    swap(position, getParent(position)); // Swap nodes of current position with
-                                         // parent if parent is greater
-    heapifyUp(getParent(position));
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::heapifyDown(int hole, heapNode moving) {
+  int size = heap.size();
+  bool prefetch = size >= prefetchMinimum;
+  int firstChild = getFirstChild(hole);
+
+  while (firstChild < size) {
+    if (prefetch) {
+      prefetchGrandchildren(firstChild);
+    }
+
+    // Only the last sibling group of the heap can be incomplete.
+    int lastChild = std::min(firstChild + Arity, size);
+
+    // Determine the minimum value child node. All siblings are adjacent in
+    // the heap vector, so this scan touches a single sibling group.
+    int minChild = firstChild;
+    for (int child = firstChild + 1; child < lastChild; child++) {
+      if (heap[child] < heap[minChild]) {
+        minChild = child;
+      }
+    }
+
+    if (!(heap[minChild] < moving)) {
+      break;
+    }
+
+    // Move the minimum child up into the hole
+    heap[hole] = heap[minChild];
+    heap[hole].getrbNodeRef()->setHeapHandle(hole);
+    hole = minChild;
+    firstChild = getFirstChild(hole);
   }
+
+  heap[hole] = moving;
+  moving.getrbNodeRef()->setHeapHandle(hole);
 }
 
 /**
- * @brief Inserts a new node into the min-heap and restores the heap property
- * @param node The node to insert into the heap.
+ * @brief Places an element into a hole, by heapifying up if it is smaller
+ * than the parent of the hole and down otherwise.
+ *
+ * @param hole The index of the hole.
+ * @param moving The element to place.
  */
-void minHeap::insert(heapNode node) {
-  heap[size] = node;
-  heap[size].pos = size;
-  heapifyUp(size);
-  size++;
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::heapify(int hole, heapNode moving) {
+  if (hole > root && moving < heap[getParent(hole)]) {
+    heapifyUp(hole, moving);
+  } else {
+    heapifyDown(hole, moving);
+  }
 }
 
 /**
- * @brief Restores the heap property by heapifying down from the given position.
+ * @brief Returns the minimum element of the heap without removing it.
  *
- * @param position The index of the element to start the heapify-down process
- * from.
+ * @return The red black node of the minimum element, or nullptr if the heap
+ * is empty.
  */
-void minHeap::heapifyDown(int position) {
-  // Check if a valid left child node exists.
-  if (isValidIndex(getLeftChild(position))) {
-    int leftChild = getLeftChild(position);
-
-    // Check if a valid right child node exists, otherwise assign the left child
-    // index.
-    int rightChild = isValidIndex(getRightChild(position))
-                         ? getRightChild(position)
-                         : leftChild;
-
-    // Determine the minimum value child node.
-    int minChild = heap[leftChild] < heap[rightChild] ? leftChild : rightChild;
-
-    // If the value of the minimum child node is less than the current node,
-    // swap them.
-    if (heap[minChild] < heap[position]) {
-      swap(position, minChild);
-      // Recursively call heapifyDown on the minimum child node to continue the
-      // heapification process.
-      heapifyDown(minChild);
-    }
+template <int Arity, typename Node, typename Priority>
+Node *minHeap<Arity, Node, Priority>::peekMin() {
+  if (isEmpty()) {
+    return nullptr;
   }
+  return heap[root].getrbNodeRef();
 }
 
 /**
- * @brief Removes and returns the minimum element from the heap.
+ * @brief Removes the minimum element from the heap.
  *
- * @return The minimum element in the heap.
+ * @return The red black node of the minimum element. Its heap position is no
+ * longer valid.
  * @throws std::runtime_error If the heap is empty.
  */
-heapNode minHeap::removeMin() {
+template <int Arity, typename Node, typename Priority>
+Node *minHeap<Arity, Node, Priority>::removeMin() {
   if (isEmpty()) {
     throw std::runtime_error("No active ride requests");
   }
 
-  // Get the minimum element & Swap the minimum element with the last element
-  heapNode minNode = heap[1];
-  swap(1, size - 1);
-
-  size--; // Decrease the size of the heap
+  // Get the minimum element and take the last element out of the heap
+  Node *minNode = heap[root].getrbNodeRef();
+  heapNode last = heap.back();
+  heap.pop_back();
 
-  // Heapify down to maintain heap property
-  heapifyDown(1);
+  // Heapify the last element down from the hole left at the root
+  if (!isEmpty()) {
+    heapifyDown(root, last);
+  }
   return minNode;
 }
 
+/**
+ * @brief Removes up to count minimum elements from the heap.
+ *
+ * @details Unlike calling removeMin repeatedly, running out of rides is not
+ * an error, so the loop has no exception path.
+ *
+ * @param count The maximum number of elements to remove.
+ * @param removed The vector the red black nodes are appended to, in priority
+ * order.
+ * @return The number of elements removed.
+ */
+template <int Arity, typename Node, typename Priority>
+int minHeap<Arity, Node, Priority>::removeMins(int count,
+                                              std::vector<Node *> &removed) {
+  int taken = 0;
+
+  for (; taken < count && !isEmpty(); taken++) {
+    removed.push_back(heap[root].getrbNodeRef());
+    heapNode last = heap.back();
+    heap.pop_back();
+    if (!isEmpty()) {
+      heapifyDown(root, last);
+    }
+  }
+  return taken;
+}
+
 /**
  * @brief Removes the element at the specified index from the heap.
  *
  * @param index The index of the element to be removed.
  */
-void minHeap::remove(int index) {
-  swap(index,
-       size - 1);     // swap the elements on last index and the required index
-  size--;             // Decrease the size of the heap
-  heapifyDown(index); // Heapify down from the index to maintain heap property
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::remove(int index) {
+  // take the last element out of the heap
+  heapNode last = heap.back();
+  heap.pop_back(); // Decrease the size of the heap
+
+  // Unless it was the removed element itself, the former last element fills
+  // the hole. It may be smaller than the parent of the hole, so it can move
+  // either up or down.
+  if (index < heap.size()) {
+    heapify(index, last);
+  }
 }
 
 /**
- * @brief Returns a pointer to the next available memory address in the heap.
+ * @brief Moves the heap node of a ride to its correct position after the cost
+ * or duration of the ride changed.
  *
- * @return A pointer to the next available memory address in the heap.
+ * @param ride The red black node of the updated ride.
  */
-heapNode *minHeap::getAddress() {
-  return &heap[size];
-}
\ No newline at end of file
+template <int Arity, typename Node, typename Priority>
+void minHeap<Arity, Node, Priority>::update(Node *ride) {
+  int position = ride->getHeapHandle();
+  heap[position].updateKey(Priority::key(*ride));
+  heapify(position, heap[position]);
+}
+
+// Arities available to the rest of the program.
+template class minHeap<2>;
+template class minHeap<4>;
+template class minHeap<8>;
@@ -1,44 +1,69 @@
 #ifndef MINHEAP_H
 #define MINHEAP_H
 
+#include "cacheAlignedAllocator.hpp"
 #include "heapNode.hpp"
+#include "rbNode.hpp"
 #include <vector>
 
+// A d-ary min-heap of rides. Arity is the number of children per node and is
+// fixed at compile time. The heap holds red black nodes of type Node and
+// orders them with the Priority policy described in rideTypes.hpp. The member
+// functions are instantiated in minHeap.cpp for GatorTaxi's nodes with arity
+// 2, 4 and 8.
+//
+// The root lives at index Arity - 1 and the children of node i occupy indexes
+// Arity * (i - Arity + 2) up to Arity * (i - Arity + 2) + Arity - 1. Every
+// sibling group therefore starts at a multiple of Arity, and with the vector
+// aligned to a cache line the four 16-byte siblings of a 4-ary heap share one
+// cache line. With Arity 2 this is the classic layout with the root at 1.
+template <int Arity = 4, typename Node = rbNode,
+          typename Priority = byCostAndDuration<typename Node::payloadType>>
 class minHeap {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
 private:
+  using heapNode = basicHeapNode<Node, Priority>;
+
   // private helper functions
 
+  // index of the root of the heap, the slots in front of it are padding
+  static constexpr int root = Arity - 1;
+
+  // heaps with at least this many slots prefetch the grandchildren while
+  // sifting down, smaller ones stay in the cache anyway
+  static constexpr int prefetchMinimum = 1 << 15;
+
   // check if the heap is empty
   bool isEmpty();
 
   // get the index of the parent of a given node
   int getParent(int index);
 
-  // get the index of the left child of a given node
-  int getLeftChild(int index);
-
-  // get the index of the right child of a given node
-  int getRightChild(int index);
+  // get the index of the first child of a given node
+  int getFirstChild(int index);
 
-  // check if a given index is a valid index in the heap
-  bool isValidIndex(int index);
+  // start loading the sibling groups of the grandchildren of a node, given
+  // the index of its first child
+  void prefetchGrandchildren(int firstChild);
 
-  // swap the elements at two given indices in the heap
-  void swap(int index1, int index2);
+  // move the hole at the given position up or down until the moving element
+  // fits there, then store the element in the hole and its index in its red
+  // black node
+  void heapifyUp(int hole, heapNode moving);
+  void heapifyDown(int hole, heapNode moving);
 
-  // perform the "heapify up" operation at a given position in the heap
-  void heapifyUp(int position);
-
-  // perform the "heapify down" operation at a given position in the heap
-  void heapifyDown(int position);
+  // place an element into the hole at the given position, moving it either up
+  // or down
+  void heapify(int hole, heapNode moving);
 
 public:
   // public member variables
-  // the underlying vector that stores the elements of the heap
-  std::vector<heapNode> heap;
-  // the current size of the heap (initialized to 1 because the root of the heap
-  // is initially empty)
-  int size = 1;
+  // the underlying vector that stores the elements of the heap (the slots in
+  // front of the root hold dummy nodes). The vector grows geometrically, so
+  // nothing outside the heap may keep pointers into it; red black nodes refer
+  // to their heap node by index instead.
+  std::vector<heapNode, cacheAlignedAllocator<heapNode>> heap;
 
   // constructor and destructor
   minHeap();
@@ -46,17 +71,32 @@ public:
 
   // public member functions
 
-  // get a pointer to the underlying vector that stores the elements of the heap
-  heapNode *getAddress();
+  // get the number of elements stored in the heap
+  int getSize() const;
+
+  // insert the ride held by a red black node into the heap and link the two
+  void insert(Node *ride);
+
+  // insert the rides of many red black nodes at once and restore the heap
+  // property bottom-up in linear time
+  void bulkInsert(const std::vector<Node *> &rides);
 
-  // insert a new element into the heap
-  void insert(heapNode node);
+  // return the red black node of the minimum element without removing it, or
+  // nullptr if the heap is empty
+  Node *peekMin();
 
-  // remove and return the minimum element from the heap
-  heapNode removeMin();
+  // remove the minimum element from the heap and return its red black node
+  Node *removeMin();
+
+  // remove up to count minimum elements and append their red black nodes to
+  // removed in priority order, returning how many were removed
+  int removeMins(int count, std::vector<Node *> &removed);
 
   // remove the element at a given index from the heap
   void remove(int index);
+
+  // reorder the heap node of a ride after its cost or duration changed
+  void update(Node *ride);
 };
 
-#endif // MINHEAP_H
\ No newline at end of file
+#endif // MINHEAP_H
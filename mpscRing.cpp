@@ -0,0 +1,104 @@
+#include "mpscRing.hpp"
+#include "ingestEngine.hpp"
+
+/**
+ * @brief Constructor for the ring.
+ *
+ * @details Cell i starts with sequence number i, which marks it as free for
+ * the producer claiming position i.
+ *
+ * @param capacity The minimum number of values the ring holds.
+ */
+template <typename T>
+mpscRing<T>::mpscRing(std::size_t capacity)
+    : mask(0), enqueuePos(0), dequeuePos(0) {
+  std::size_t size = 2;
+  while (size < capacity) {
+    size *= 2;
+  }
+  mask = size - 1;
+
+  cells.reset(new cell[size]);
+  for (std::size_t i = 0; i < size; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Destructor for the ring.
+ */
+template <typename T> mpscRing<T>::~mpscRing() {}
+
+/**
+ * @brief Returns the number of values the ring can hold.
+ *
+ * @return The capacity of the ring.
+ */
+template <typename T> std::size_t mpscRing<T>::getCapacity() const {
+  return mask + 1;
+}
+
+/**
+ * @brief Appends a value to the ring.
+ *
+ * @details The cell at the enqueue position is free when its sequence number
+ * equals the position. A smaller sequence number means the consumer has not
+ * freed the cell since the last lap, so the ring is full. A larger one means
+ * another producer claimed the position first, so the position is reloaded.
+ *
+ * @param value The value to append.
+ * @return false if the ring is full, true otherwise.
+ */
+template <typename T> bool mpscRing<T>::tryPush(const T &value) {
+  std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+  cell *target;
+
+  while (true) {
+    target = &cells[pos & mask];
+    std::size_t sequence = target->sequence.load(std::memory_order_acquire);
+    std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+    if (diff == 0) {
+      // On failure the current position is loaded into pos.
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  target->value = value;
+  target->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * @brief Removes the oldest value from the ring.
+ *
+ * @details The cell at the dequeue position holds a value once its sequence
+ * number is one past the position. After reading the value, the cell is
+ * handed to the producer of the next lap.
+ *
+ * @param value Receives the removed value.
+ * @return false if the ring is empty, true otherwise.
+ */
+template <typename T> bool mpscRing<T>::tryPop(T &value) {
+  cell *source = &cells[dequeuePos & mask];
+  std::size_t sequence = source->sequence.load(std::memory_order_acquire);
+
+  if (sequence != dequeuePos + 1) {
+    return false;
+  }
+
+  value = source->value;
+  source->sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+  dequeuePos++;
+  return true;
+}
+
+// Element types available to the rest of the program.
+template class mpscRing<ingestRequest>;
@@ -0,0 +1,56 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include "cacheAlignedAllocator.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// A bounded lock-free queue for many producer threads and one consumer
+// thread, after Dmitry Vyukov's bounded MPMC queue. Every cell carries a
+// sequence number that tells whose turn it is: a producer claims a free cell
+// by advancing the shared enqueue position with a compare-and-swap, fills it
+// and publishes it by bumping the sequence, and the consumer frees it again
+// by bumping the sequence by one lap. Producers never wait for each other
+// beyond a failed compare-and-swap, and a full queue is reported instead of
+// blocking.
+template <typename T> class mpscRing {
+private:
+  // A slot of the ring on its own cache line, so producers filling
+  // neighbouring cells do not invalidate each other's lines.
+  struct alignas(cacheLineSize) cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  // capacity - 1, the capacity being a power of two
+  std::size_t mask;
+  std::unique_ptr<cell[]> cells;
+
+  // Next position to be claimed by a producer, shared by all producers.
+  alignas(cacheLineSize) std::atomic<std::size_t> enqueuePos;
+
+  // Next position to be read, touched only by the consumer.
+  alignas(cacheLineSize) std::size_t dequeuePos;
+
+public:
+  // Creates a ring holding at least the given number of values, rounded up to
+  // a power of two.
+  explicit mpscRing(std::size_t capacity);
+  ~mpscRing();
+
+  mpscRing(const mpscRing &) = delete;
+  mpscRing &operator=(const mpscRing &) = delete;
+
+  std::size_t getCapacity() const;
+
+  // Appends a value, returning false if the ring is full. Safe to call from
+  // any number of threads at once.
+  bool tryPush(const T &value);
+
+  // Removes the oldest value, returning false if the ring is empty. Must only
+  // be called by the consumer thread.
+  bool tryPop(T &value);
+};
+
+#endif // MPSCRING_H
@@ -0,0 +1,276 @@
+#include "outputWriter.hpp"
+#include "binaryFormat.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+// Longest text of a 64-bit integer, including the sign.
+const std::size_t maxIntLength = 20;
+
+// Two digit decimal representations of 0 to 99, so that integers are
+// formatted two digits at a time.
+const char digitPairs[] = "00010203040506070809"
+                          "10111213141516171819"
+                          "20212223242526272829"
+                          "30313233343536373839"
+                          "40414243444546474849"
+                          "50515253545556575859"
+                          "60616263646566676869"
+                          "70717273747576777879"
+                          "80818283848586878889"
+                          "90919293949596979899";
+
+} // namespace
+
+/**
+ * @brief Constructor for outputWriter class.
+ *
+ * @param fileName Path of the output file, which is truncated.
+ * @param format Format of the results, a binary file starts with a header.
+ * @param capacity Size of the output buffer in bytes.
+ * @throws std::runtime_error If the file cannot be opened.
+ */
+outputWriter::outputWriter(const char *fileName, outputFormat format,
+                           std::size_t capacity)
+    : format(format), buffer(new char[capacity]), capacity(capacity),
+      used(0) {
+  fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("could not open file ") + fileName);
+  }
+
+  if (format == outputFormat::BINARY) {
+    encodeHeader(resultLogMagic, buffer.get());
+    used = binaryHeaderSize;
+  }
+}
+
+/**
+ * @brief Destructor for outputWriter class.
+ *
+ * @details Flushes the remaining output and closes the file.
+ */
+outputWriter::~outputWriter() {
+  try {
+    flush();
+  } catch (const std::exception &) {
+    // A destructor must not throw, the output is lost at this point.
+  }
+  close(fd);
+}
+
+/**
+ * @brief Flushes the buffer if it cannot take the given number of bytes.
+ *
+ * @param bytes The number of bytes about to be written.
+ */
+void outputWriter::reserve(std::size_t bytes) {
+  if (capacity - used < bytes) {
+    flush();
+  }
+}
+
+/**
+ * @brief Appends the decimal representation of an integer to the buffer.
+ *
+ * @details The digits are produced from the least significant end into a
+ * small scratch area, two at a time, and then copied into the buffer.
+ *
+ * @param value The integer to write.
+ */
+void outputWriter::writeInt(std::int64_t value) {
+  char scratch[maxIntLength];
+  char *end = scratch + maxIntLength;
+  char *pos = end;
+
+  // Work on the magnitude as unsigned, so that the smallest value does not
+  // overflow.
+  std::uint64_t magnitude = value < 0
+                                ? 0u - static_cast<std::uint64_t>(value)
+                                : static_cast<std::uint64_t>(value);
+
+  while (magnitude >= 100) {
+    unsigned int pair = magnitude % 100;
+    magnitude /= 100;
+    pos -= 2;
+    std::memcpy(pos, digitPairs + 2 * pair, 2);
+  }
+  if (magnitude >= 10) {
+    pos -= 2;
+    std::memcpy(pos, digitPairs + 2 * magnitude, 2);
+  } else {
+    *--pos = static_cast<char>('0' + magnitude);
+  }
+  if (value < 0) {
+    *--pos = '-';
+  }
+
+  std::memcpy(buffer.get() + used, pos, end - pos);
+  used += end - pos;
+}
+
+/**
+ * @brief Appends a binary result tag to the buffer.
+ *
+ * @param tag The tag of the record.
+ */
+void outputWriter::writeTag(unsigned char tag) {
+  buffer[used++] = static_cast<char>(tag);
+}
+
+/**
+ * @brief Writes a ride as the triplet (rideNumber,rideCost,tripDuration), or
+ * as a ride record in the binary format.
+ *
+ * @param rideNumber The ride number.
+ * @param rideCost The ride cost.
+ * @param tripDuration The trip duration.
+ */
+void outputWriter::writeRide(std::int64_t rideNumber, int rideCost,
+                             int tripDuration) {
+  if (format == outputFormat::BINARY) {
+    reserve(1 + rideRecordSize);
+    writeTag(static_cast<unsigned char>(resultTag::RIDE));
+    encodeRide(rideNumber, rideCost, tripDuration, buffer.get() + used);
+    used += rideRecordSize;
+    return;
+  }
+
+  reserve(3 * maxIntLength + 4);
+
+  char *text = buffer.get();
+  text[used++] = '(';
+  writeInt(rideNumber);
+  text[used++] = ',';
+  writeInt(rideCost);
+  text[used++] = ',';
+  writeInt(tripDuration);
+  text[used++] = ')';
+}
+
+/**
+ * @brief Writes a number in decimal, or as a number record in the binary
+ * format.
+ *
+ * @param value The number to write.
+ */
+void outputWriter::writeNumber(int value) {
+  if (format == outputFormat::BINARY) {
+    std::int32_t field = value;
+    reserve(1 + sizeof(field));
+    writeTag(static_cast<unsigned char>(resultTag::NUMBER));
+    std::memcpy(buffer.get() + used, &field, sizeof(field));
+    used += sizeof(field);
+    return;
+  }
+
+  reserve(maxIntLength);
+  writeInt(value);
+}
+
+/**
+ * @brief Writes the punctuation between rides. The binary format has no
+ * punctuation, so nothing is written there.
+ *
+ * @param c The character to write.
+ */
+void outputWriter::writeSeparator(char c) {
+  if (format == outputFormat::TEXT) {
+    reserve(1);
+    buffer[used++] = c;
+  }
+}
+
+/**
+ * @brief Writes a null terminated message, prefixed with its tag and length
+ * in the binary format.
+ *
+ * @param text The message to write.
+ */
+void outputWriter::writeString(const char *text) {
+  std::uint32_t length = std::strlen(text);
+
+  if (format == outputFormat::BINARY) {
+    reserve(1 + sizeof(length));
+    writeTag(static_cast<unsigned char>(resultTag::MESSAGE));
+    std::memcpy(buffer.get() + used, &length, sizeof(length));
+    used += sizeof(length);
+  }
+
+  writeBytes(text, length);
+}
+
+/**
+ * @brief Terminates the current result with a newline, or with an end of
+ * result record in the binary format.
+ */
+void outputWriter::endLine() {
+  reserve(1);
+  if (format == outputFormat::BINARY) {
+    writeTag(static_cast<unsigned char>(resultTag::END_OF_RESULT));
+  } else {
+    buffer[used++] = '\n';
+  }
+}
+
+/**
+ * @brief Writes raw bytes, whatever the format of the writer.
+ *
+ * @param bytes The bytes to write.
+ * @param count The number of bytes.
+ */
+void outputWriter::writeBytes(const void *bytes, std::size_t count) {
+  const char *source = static_cast<const char *>(bytes);
+
+  while (count > 0) {
+    reserve(1);
+    std::size_t chunk = capacity - used < count ? capacity - used : count;
+    std::memcpy(buffer.get() + used, source, chunk);
+    used += chunk;
+    source += chunk;
+    count -= chunk;
+  }
+}
+
+/**
+ * @brief Writes the buffered output to the file, after running the barrier.
+ *
+ * @throws std::runtime_error If the file cannot be written, or whatever the
+ * barrier throws.
+ */
+void outputWriter::flush() {
+  std::size_t written = 0;
+
+  if (used > 0 && barrier) {
+    barrier();
+  }
+
+  while (written < used) {
+    ssize_t result = write(fd, buffer.get() + written, used - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("could not write output file");
+    }
+    written += result;
+  }
+
+  used = 0;
+}
+
+/**
+ * @brief Sets the function run before buffered output is written.
+ *
+ * @param barrier The function, or an empty function for none.
+ */
+void outputWriter::setBarrier(std::function<void()> barrier) {
+  this->barrier = std::move(barrier);
+}
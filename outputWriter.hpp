@@ -0,0 +1,72 @@
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Formats in which the results can be written.
+enum class outputFormat { TEXT, BINARY };
+
+// Buffered writer for the results of the dispatcher. Output is collected in a
+// large user-space buffer and written to the file only when the buffer runs
+// full, when flush() is called at the end of a batch, or when the writer is
+// destroyed. In the text format integers are formatted by hand instead of
+// through iostreams; the binary format is described in binaryFormat.hpp.
+class outputWriter {
+private:
+  int fd;                         // Descriptor of the output file.
+  outputFormat format;            // Format of the results.
+  std::unique_ptr<char[]> buffer; // Pending output.
+  std::size_t capacity, used;     // Size and fill level of the buffer.
+  std::function<void()> barrier;  // Runs before output reaches the file.
+
+  // Makes room for at least the given number of bytes in the buffer.
+  void reserve(std::size_t bytes);
+
+  // Appends the decimal representation of an integer to the buffer.
+  void writeInt(std::int64_t value);
+
+  // Appends a binary result tag to the buffer.
+  void writeTag(unsigned char tag);
+
+public:
+  // Constructor truncates or creates the given file, destructor flushes and
+  // closes it. Throws std::runtime_error if the file cannot be opened.
+  explicit outputWriter(const char *fileName,
+                        outputFormat format = outputFormat::TEXT,
+                        std::size_t capacity = 1 << 20);
+  ~outputWriter();
+
+  outputWriter(const outputWriter &) = delete;
+  outputWriter &operator=(const outputWriter &) = delete;
+
+  // Writes a ride as the triplet (rideNumber,rideCost,tripDuration).
+  void writeRide(std::int64_t rideNumber, int rideCost, int tripDuration);
+
+  // Writes a number, such as a count of rides.
+  void writeNumber(int value);
+
+  // Writes the punctuation between rides, which the binary format omits.
+  void writeSeparator(char c);
+
+  // Writes a null terminated message.
+  void writeString(const char *text);
+
+  // Terminates the current result, which is a line in the text format.
+  void endLine();
+
+  // Writes raw bytes, whatever the format.
+  void writeBytes(const void *bytes, std::size_t count);
+
+  // Writes the buffered output to the file.
+  void flush();
+
+  // Sets a function that runs before any buffered output is written, such as
+  // committing the write-ahead log so that no result is seen before the
+  // commands behind it are durable.
+  void setBarrier(std::function<void()> barrier);
+};
+
+#endif // OUTPUTWRITER_H
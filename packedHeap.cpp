@@ -0,0 +1,338 @@
+#include "packedHeap.hpp"
+#include "rbNode.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Constructor for the packed heap.
+ *
+ * @details Fills the slots in front of the root and the root itself with
+ * padding, so the arrays always end on a sibling group boundary. The arrays
+ * grow on demand, so there is no upper bound on the number of rides.
+ */
+template <int Arity> packedHeap<Arity>::packedHeap() : end(root) {
+  keys.assign(Arity, paddingKey);
+  rides.assign(Arity, nullptr);
+}
+
+/**
+ * @brief Destructor for the packed heap.
+ */
+template <int Arity> packedHeap<Arity>::~packedHeap() {}
+
+/**
+ * @brief Checks if the heap is empty.
+ *
+ * @return True if the heap contains no elements, false otherwise.
+ */
+template <int Arity> bool packedHeap<Arity>::isEmpty() {
+  return end <= root;
+}
+
+/**
+ * @brief Returns the number of elements stored in the heap.
+ *
+ * @return The number of elements, not counting the padding.
+ */
+template <int Arity> int packedHeap<Arity>::getSize() const {
+  return end - root;
+}
+
+/**
+ * @brief Calculates the index of the parent of a given index in the heap.
+ *
+ * @param index The index of the child node.
+ * @return The index of the parent node.
+ */
+template <int Arity> int packedHeap<Arity>::getParent(int index) {
+  return index / Arity + root - 1;
+}
+
+/**
+ * @brief Calculates the index of the first child of a given index in the
+ * heap. The remaining children follow it directly.
+ *
+ * @param index The index of the parent node.
+ * @return The index of the first child node.
+ */
+template <int Arity> int packedHeap<Arity>::getFirstChild(int index) {
+  return Arity * (index - root + 1);
+}
+
+/**
+ * @brief Finds the child with the smallest key in a sibling group.
+ *
+ * @details The group is always complete thanks to the padding, so the loop has
+ * a fixed trip count and every step is a pair of conditional moves, which the
+ * compiler can unroll or vectorize. On equal keys the first child wins, so a
+ * padding slot is never chosen over a real child.
+ *
+ * @param firstChild The index of the first child of the group.
+ * @return The index of the minimum child.
+ */
+template <int Arity> int packedHeap<Arity>::getMinChild(int firstChild) {
+  const std::uint64_t *group = keys.data() + firstChild;
+  std::uint64_t minKey = group[0];
+  int minOffset = 0;
+
+  for (int offset = 1; offset < Arity; offset++) {
+    bool smaller = group[offset] < minKey;
+    minKey = smaller ? group[offset] : minKey;
+    minOffset = smaller ? offset : minOffset;
+  }
+
+  return firstChild + minOffset;
+}
+
+/**
+ * @brief Starts loading the keys of the grandchildren of a node into the
+ * cache.
+ *
+ * @details The grandchildren are the children of the sibling group of the
+ * node, Arity groups that lie next to each other in the key array. Only keys
+ * are prefetched, since picking the minimum child reads nothing else.
+ *
+ * @param firstChild The index of the first child of the node.
+ */
+template <int Arity>
+void packedHeap<Arity>::prefetchGrandchildren(int firstChild) {
+  int first = getFirstChild(firstChild);
+  int last = std::min<int>(first + Arity * Arity, keys.size());
+  constexpr int perLine = cacheLineSize / sizeof(std::uint64_t);
+
+  for (int index = first; index < last; index += perLine) {
+    __builtin_prefetch(&keys[index]);
+  }
+}
+
+/**
+ * @brief Restores the heap property by moving a hole up from the given
+ * position while the parent has a greater key than the moving ride.
+ *
+ * @details Each parent on the way is copied down into the hole once, and the
+ * moving ride is only written when its final position is known.
+ *
+ * @param hole The index of the hole.
+ * @param key The key of the moving ride.
+ * @param ride The red black node of the moving ride.
+ */
+template <int Arity>
+void packedHeap<Arity>::heapifyUp(int hole, std::uint64_t key, rbNode *ride) {
+  while (hole > root) {
+    int parent = getParent(hole);
+    if (key >= keys[parent]) {
+      break;
+    }
+
+    // Move the parent down into the hole
+    keys[hole] = keys[parent];
+    rides[hole] = rides[parent];
+    rides[hole]->setHeapHandle(hole);
+    hole = parent;
+  }
+
+  keys[hole] = key;
+  rides[hole] = ride;
+  ride->setHeapHandle(hole);
+}
+
+/**
+ * @brief Inserts the ride of a red black node into the heap, links the red
+ * black node to its slot, and restores the heap property.
+ *
+ * @param ride The red black node holding the ride to insert into the heap.
+ */
+template <int Arity> void packedHeap<Arity>::insert(rbNode *ride) {
+  int position = end++;
+
+  // Grow both arrays by a whole sibling group, keeping the key array padded.
+  if (position == keys.size()) {
+    keys.resize(keys.size() + Arity, paddingKey);
+    rides.resize(keys.size(), nullptr);
+  }
+
+  // The new slot is the hole the ride starts from.
+  heapifyUp(position, packKey(ride->rideCost, ride->tripDuration), ride);
+}
+
+/**
+ * @brief Inserts the rides held by many red black nodes into the heap.
+ *
+ * @details The keys are appended in any order and the heap property is then
+ * restored with Floyd's method, heapifying down every parent from the last
+ * one up to the root. This takes linear time in the size of the heap, rather
+ * than O(m log n) for inserting the rides one at a time.
+ *
+ * @param newRides The red black nodes holding the rides to insert.
+ */
+template <int Arity>
+void packedHeap<Arity>::bulkInsert(const std::vector<rbNode *> &newRides) {
+  if (newRides.empty()) {
+    return;
+  }
+
+  // Grow both arrays to the end of the sibling group holding the last ride.
+  int groups = (end + newRides.size() + Arity - 1) / Arity;
+  if (groups * Arity > keys.size()) {
+    keys.resize(groups * Arity, paddingKey);
+    rides.resize(keys.size(), nullptr);
+  }
+
+  for (rbNode *ride : newRides) {
+    int position = end++;
+
+    keys[position] = packKey(ride->rideCost, ride->tripDuration);
+    rides[position] = ride;
+    ride->setHeapHandle(position);
+  }
+
+  for (int position = getParent(end - 1); position >= root; position--) {
+    heapifyDown(position, keys[position], rides[position]);
+  }
+}
+
+/**
+ * @brief Restores the heap property by moving a hole down from the given
+ * position while its minimum child has a smaller key than the moving ride.
+ *
+ * @details As in heapifyUp, every child on the way is copied up into the hole
+ * once and the moving ride is written last. In heaps too large for the cache
+ * the keys of the grandchildren are prefetched one level ahead.
+ *
+ * @param hole The index of the hole.
+ * @param key The key of the moving ride.
+ * @param ride The red black node of the moving ride.
+ */
+template <int Arity>
+void packedHeap<Arity>::heapifyDown(int hole, std::uint64_t key,
+                                    rbNode *ride) {
+  bool prefetch = end >= prefetchMinimum;
+  int firstChild = getFirstChild(hole);
+
+  while (firstChild < end) {
+    if (prefetch) {
+      prefetchGrandchildren(firstChild);
+    }
+
+    int minChild = getMinChild(firstChild);
+    if (keys[minChild] >= key) {
+      break;
+    }
+
+    // Move the minimum child up into the hole
+    keys[hole] = keys[minChild];
+    rides[hole] = rides[minChild];
+    rides[hole]->setHeapHandle(hole);
+    hole = minChild;
+    firstChild = getFirstChild(hole);
+  }
+
+  keys[hole] = key;
+  rides[hole] = ride;
+  ride->setHeapHandle(hole);
+}
+
+/**
+ * @brief Places a ride into a hole, by heapifying up if its key is smaller
+ * than the key of the parent of the hole and down otherwise.
+ *
+ * @param hole The index of the hole.
+ * @param key The key of the moving ride.
+ * @param ride The red black node of the moving ride.
+ */
+template <int Arity>
+void packedHeap<Arity>::heapify(int hole, std::uint64_t key, rbNode *ride) {
+  if (hole > root && key < keys[getParent(hole)]) {
+    heapifyUp(hole, key, ride);
+  } else {
+    heapifyDown(hole, key, ride);
+  }
+}
+
+/**
+ * @brief Returns the minimum element of the heap without removing it.
+ *
+ * @return The red black node of the minimum element, or nullptr if the heap
+ * is empty.
+ */
+template <int Arity> rbNode *packedHeap<Arity>::peekMin() {
+  if (isEmpty()) {
+    return nullptr;
+  }
+  return rides[root];
+}
+
+/**
+ * @brief Removes the minimum element from the heap.
+ *
+ * @return The red black node of the minimum element. Its heap position is no
+ * longer valid.
+ * @throws std::runtime_error If the heap is empty.
+ */
+template <int Arity> rbNode *packedHeap<Arity>::removeMin() {
+  if (isEmpty()) {
+    throw std::runtime_error("No active ride requests");
+  }
+
+  rbNode *minNode = rides[root];
+  remove(root);
+  return minNode;
+}
+
+/**
+ * @brief Removes up to count minimum elements from the heap.
+ *
+ * @details Unlike calling removeMin repeatedly, running out of rides is not
+ * an error, so the loop has no exception path.
+ *
+ * @param count The maximum number of elements to remove.
+ * @param removed The vector the red black nodes are appended to, in priority
+ * order.
+ * @return The number of elements removed.
+ */
+template <int Arity>
+int packedHeap<Arity>::removeMins(int count, std::vector<rbNode *> &removed) {
+  int taken = 0;
+
+  for (; taken < count && !isEmpty(); taken++) {
+    removed.push_back(rides[root]);
+    remove(root);
+  }
+  return taken;
+}
+
+/**
+ * @brief Removes the element at the specified index from the heap.
+ *
+ * @param index The index of the element to be removed.
+ */
+template <int Arity> void packedHeap<Arity>::remove(int index) {
+  // take the last ride out of the heap and turn its slot back into padding
+  end--;
+  std::uint64_t key = keys[end];
+  rbNode *ride = rides[end];
+  keys[end] = paddingKey;
+  rides[end] = nullptr;
+
+  // Unless it was the removed ride itself, the former last ride fills the
+  // hole. It may be smaller than the parent of the hole, so it can move
+  // either up or down.
+  if (index < end) {
+    heapify(index, key, ride);
+  }
+}
+
+/**
+ * @brief Moves a ride to its correct position after its cost or duration
+ * changed.
+ *
+ * @param ride The red black node of the updated ride.
+ */
+template <int Arity> void packedHeap<Arity>::update(rbNode *ride) {
+  int position = ride->getHeapHandle();
+  heapify(position, packKey(ride->rideCost, ride->tripDuration), ride);
+}
+
+// Arities available to the rest of the program.
+template class packedHeap<4>;
+template class packedHeap<8>;
@@ -0,0 +1,102 @@
+#ifndef PACKEDHEAP_H
+#define PACKEDHEAP_H
+
+#include "cacheAlignedAllocator.hpp"
+#include "rbNode.hpp"
+#include <cstdint>
+#include <vector>
+
+// A d-ary min-heap of rides stored as a structure of arrays. The priority of a
+// ride is packed into one 64-bit key, with the ride cost in the high half and
+// the trip duration in the low half, so comparing two rides is a single
+// unsigned comparison. The keys live in their own dense array and the links to
+// the red black nodes in a parallel one, so picking the minimum child only
+// reads the keys. It offers the same interface as minHeap and uses the same
+// index layout, so the positions stored in rbNode work for both.
+//
+// The key array is padded with the largest key up to the end of the last
+// sibling group. The minimum child is therefore always selected from a full
+// group with a fixed-width, branch-free reduction. With Arity 8 a group is
+// one cache line of keys.
+template <int Arity = 8> class packedHeap {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
+private:
+  // index of the root of the heap, the slots in front of it are padding
+  static constexpr int root = Arity - 1;
+
+  // key stored in the padding slots, never smaller than a real key
+  static constexpr std::uint64_t paddingKey = UINT64_MAX;
+
+  // heaps with at least this many slots prefetch the keys of the
+  // grandchildren while sifting down, smaller ones stay in the cache anyway
+  static constexpr int prefetchMinimum = 1 << 15;
+
+  // number of used slots, including the padding in front of the root
+  int end;
+
+  // check if the heap is empty
+  bool isEmpty();
+
+  // get the index of the parent of a given node
+  int getParent(int index);
+
+  // get the index of the first child of a given node
+  int getFirstChild(int index);
+
+  // get the index of the minimum child in the sibling group starting at the
+  // given index
+  int getMinChild(int firstChild);
+
+  // start loading the keys of the grandchildren of a node, given the index
+  // of its first child
+  void prefetchGrandchildren(int firstChild);
+
+  // move the hole at the given position up or down until the moving ride
+  // with the given key fits there, then store the ride in the hole and its
+  // index in its red black node
+  void heapifyUp(int hole, std::uint64_t key, rbNode *ride);
+  void heapifyDown(int hole, std::uint64_t key, rbNode *ride);
+
+  // place a ride into the hole at the given position, moving it either up or
+  // down
+  void heapify(int hole, std::uint64_t key, rbNode *ride);
+
+public:
+  // the packed keys of the heap and the red black nodes they belong to
+  std::vector<std::uint64_t, cacheAlignedAllocator<std::uint64_t>> keys;
+  std::vector<rbNode *> rides;
+
+  // constructor and destructor
+  packedHeap();
+  ~packedHeap();
+
+  // get the number of elements stored in the heap
+  int getSize() const;
+
+  // insert the ride held by a red black node into the heap and link the two
+  void insert(rbNode *ride);
+
+  // insert the rides of many red black nodes at once and restore the heap
+  // property bottom-up in linear time
+  void bulkInsert(const std::vector<rbNode *> &newRides);
+
+  // return the red black node of the minimum element without removing it, or
+  // nullptr if the heap is empty
+  rbNode *peekMin();
+
+  // remove the minimum element from the heap and return its red black node
+  rbNode *removeMin();
+
+  // remove up to count minimum elements and append their red black nodes to
+  // removed in priority order, returning how many were removed
+  int removeMins(int count, std::vector<rbNode *> &removed);
+
+  // remove the element at a given index from the heap
+  void remove(int index);
+
+  // reorder the heap node of a ride after its cost or duration changed
+  void update(rbNode *ride);
+};
+
+#endif // PACKEDHEAP_H
@@ -0,0 +1,271 @@
+#include "pairingHeap.hpp"
+#include "rbNode.hpp"
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Constructor for the pairing heap.
+ */
+pairingHeap::pairingHeap() : rootNode(-1), freeList(-1), count(0) {}
+
+/**
+ * @brief Destructor for the pairing heap.
+ */
+pairingHeap::~pairingHeap() {}
+
+/**
+ * @brief Returns the number of elements stored in the heap.
+ *
+ * @return The number of rides.
+ */
+int pairingHeap::getSize() const {
+  return count;
+}
+
+/**
+ * @brief Takes a node from the free list, or appends one, for a ride and
+ * stores the index of the node in the red black node of the ride.
+ *
+ * @param ride The red black node holding the ride.
+ * @return The index of the node, which is a tree of its own.
+ */
+int pairingHeap::allocate(rbNode *ride) {
+  int index = freeList;
+  if (index >= 0) {
+    freeList = nodes[index].sibling;
+  } else {
+    index = nodes.size();
+    nodes.emplace_back();
+  }
+
+  nodes[index] = {packKey(ride->rideCost, ride->tripDuration), ride, -1, -1,
+                  -1};
+  ride->setHeapHandle(index);
+  return index;
+}
+
+/**
+ * @brief Puts a node on the free list.
+ *
+ * @param index The index of the node, which must not be linked anymore.
+ */
+void pairingHeap::release(int index) {
+  nodes[index].ride = nullptr;
+  nodes[index].sibling = freeList;
+  freeList = index;
+}
+
+/**
+ * @brief Links two trees by making the root with the larger key the first
+ * child of the other.
+ *
+ * @param first The root of a tree, or -1.
+ * @param second The root of another tree, or -1.
+ * @return The root of the combined tree.
+ */
+int pairingHeap::meld(int first, int second) {
+  if (first < 0) {
+    return second;
+  }
+  if (second < 0) {
+    return first;
+  }
+  if (nodes[second].key < nodes[first].key) {
+    std::swap(first, second);
+  }
+
+  int child = nodes[first].child;
+  nodes[second].sibling = child;
+  nodes[second].prev = first;
+  if (child >= 0) {
+    nodes[child].prev = second;
+  }
+  nodes[first].child = second;
+  return first;
+}
+
+/**
+ * @brief Cuts the subtree of a node out of the list of children of its
+ * parent, leaving it a tree of its own.
+ *
+ * @param index The index of a node other than the root.
+ */
+void pairingHeap::detach(int index) {
+  int prev = nodes[index].prev;
+  int sibling = nodes[index].sibling;
+
+  if (nodes[prev].child == index) {
+    nodes[prev].child = sibling;
+  } else {
+    nodes[prev].sibling = sibling;
+  }
+  if (sibling >= 0) {
+    nodes[sibling].prev = prev;
+  }
+
+  nodes[index].prev = -1;
+  nodes[index].sibling = -1;
+}
+
+/**
+ * @brief Combines a list of sibling trees into one tree.
+ *
+ * @details The first pass links the trees in pairs from left to right, and
+ * the second pass links the pairs into one tree from right to left. Both
+ * passes are loops, so a long list of children does not deepen the stack.
+ *
+ * @param first The root of the first tree in the list, or -1.
+ * @return The root of the combined tree, or -1 for an empty list.
+ */
+int pairingHeap::mergePairs(int first) {
+  pairs.clear();
+
+  while (first >= 0) {
+    int second = nodes[first].sibling;
+    int next = second >= 0 ? nodes[second].sibling : -1;
+
+    nodes[first].sibling = nodes[first].prev = -1;
+    if (second >= 0) {
+      nodes[second].sibling = nodes[second].prev = -1;
+    }
+
+    pairs.push_back(meld(first, second));
+    first = next;
+  }
+
+  int root = -1;
+  while (!pairs.empty()) {
+    root = meld(pairs.back(), root);
+    pairs.pop_back();
+  }
+  return root;
+}
+
+/**
+ * @brief Inserts the ride of a red black node into the heap as a tree of its
+ * own and links it with the root.
+ *
+ * @param ride The red black node holding the ride to insert into the heap.
+ */
+void pairingHeap::insert(rbNode *ride) {
+  rootNode = meld(rootNode, allocate(ride));
+  count++;
+}
+
+/**
+ * @brief Inserts the rides held by many red black nodes into the heap.
+ *
+ * @details Each insert takes constant time, so inserting the rides one at a
+ * time is already linear in their number.
+ *
+ * @param rides The red black nodes holding the rides to insert.
+ */
+void pairingHeap::bulkInsert(const std::vector<rbNode *> &rides) {
+  nodes.reserve(count + rides.size());
+  for (rbNode *ride : rides) {
+    insert(ride);
+  }
+}
+
+/**
+ * @brief Returns the minimum element of the heap without removing it.
+ *
+ * @return The red black node of the minimum element, or nullptr if the heap
+ * is empty.
+ */
+rbNode *pairingHeap::peekMin() {
+  if (rootNode < 0) {
+    return nullptr;
+  }
+  return nodes[rootNode].ride;
+}
+
+/**
+ * @brief Removes the minimum element from the heap.
+ *
+ * @return The red black node of the minimum element. Its handle is no longer
+ * valid.
+ * @throws std::runtime_error If the heap is empty.
+ */
+rbNode *pairingHeap::removeMin() {
+  if (rootNode < 0) {
+    throw std::runtime_error("No active ride requests");
+  }
+
+  rbNode *minNode = nodes[rootNode].ride;
+  remove(rootNode);
+  return minNode;
+}
+
+/**
+ * @brief Removes up to count minimum elements from the heap.
+ *
+ * @param count The maximum number of elements to remove.
+ * @param removed The vector the red black nodes are appended to, in priority
+ * order.
+ * @return The number of elements removed.
+ */
+int pairingHeap::removeMins(int count, std::vector<rbNode *> &removed) {
+  int taken = 0;
+
+  for (; taken < count && rootNode >= 0; taken++) {
+    removed.push_back(nodes[rootNode].ride);
+    remove(rootNode);
+  }
+  return taken;
+}
+
+/**
+ * @brief Removes the element with the given handle from the heap.
+ *
+ * @details The children of the node are combined into one tree, which takes
+ * the place of the root if the node was the root, and is linked with the
+ * root otherwise.
+ *
+ * @param index The index of the node of the element.
+ */
+void pairingHeap::remove(int index) {
+  int children = mergePairs(nodes[index].child);
+  nodes[index].child = -1;
+
+  if (index == rootNode) {
+    rootNode = children;
+  } else {
+    detach(index);
+    rootNode = meld(rootNode, children);
+  }
+
+  release(index);
+  count--;
+}
+
+/**
+ * @brief Moves a ride to its correct position after its cost or duration
+ * changed.
+ *
+ * @details A node whose key got smaller is cut out with its subtree, which
+ * stays ordered, and linked with the root. A node whose key got larger may be
+ * larger than its children, so they are combined and linked with the root on
+ * their own before the node follows them.
+ *
+ * @param ride The red black node of the updated ride.
+ */
+void pairingHeap::update(rbNode *ride) {
+  int index = ride->getHeapHandle();
+  std::uint64_t key = packKey(ride->rideCost, ride->tripDuration);
+  bool increased = key > nodes[index].key;
+  nodes[index].key = key;
+
+  int rest = -1;
+  if (index != rootNode) {
+    detach(index);
+    rest = rootNode;
+  }
+
+  if (increased) {
+    rest = meld(rest, mergePairs(nodes[index].child));
+    nodes[index].child = -1;
+  }
+
+  rootNode = meld(rest, index);
+}
@@ -0,0 +1,84 @@
+#ifndef PAIRINGHEAP_H
+#define PAIRINGHEAP_H
+
+#include "rbNode.hpp"
+#include <cstdint>
+#include <vector>
+
+// A pairing heap of rides. Inserting a ride and lowering its priority only
+// link one tree below another, which takes constant time, and the work of
+// restoring order is deferred to removing the minimum, where the subtrees of
+// the old root are combined with the two-pass method in amortized O(log n).
+// It offers the same interface as minHeap, so it can replace it anywhere.
+//
+// The nodes live in one array and refer to each other by index, like the
+// slots of the array heaps, so the handle stored in rbNode is the index of
+// the node of the ride. Freed nodes are kept on a free list for reuse, so a
+// handle stays valid until its ride is removed. The priority of a ride is
+// packed into one 64-bit key with packKey, like in packedHeap.
+class pairingHeap {
+private:
+  // A node of the heap. Each node links to its first child and its next
+  // sibling. prev is the previous sibling, or the parent for a first child,
+  // which lets a node be cut out of its parent in constant time.
+  struct node {
+    std::uint64_t key;
+    rbNode *ride;
+    int child, sibling, prev;
+  };
+
+  std::vector<node> nodes; // All nodes, in use or free.
+  int rootNode;            // Index of the root, -1 if the heap is empty.
+  int freeList;            // First free node, chained through sibling.
+  int count;               // Number of rides in the heap.
+  std::vector<int> pairs;  // Scratch space of mergePairs.
+
+  // take a free node for a ride and link the ride to it
+  int allocate(rbNode *ride);
+
+  // put a node on the free list
+  void release(int index);
+
+  // link two trees, either of which may be -1, and return the new root
+  int meld(int first, int second);
+
+  // cut the subtree of a node that is not the root out of its parent
+  void detach(int index);
+
+  // combine a list of sibling trees into one with the two-pass method and
+  // return its root, or -1 for an empty list
+  int mergePairs(int first);
+
+public:
+  // constructor and destructor
+  pairingHeap();
+  ~pairingHeap();
+
+  // get the number of elements stored in the heap
+  int getSize() const;
+
+  // insert the ride held by a red black node into the heap and link the two
+  void insert(rbNode *ride);
+
+  // insert the rides of many red black nodes at once, in linear time
+  void bulkInsert(const std::vector<rbNode *> &rides);
+
+  // return the red black node of the minimum element without removing it, or
+  // nullptr if the heap is empty
+  rbNode *peekMin();
+
+  // remove the minimum element from the heap and return its red black node
+  rbNode *removeMin();
+
+  // remove up to count minimum elements and append their red black nodes to
+  // removed in priority order, returning how many were removed
+  int removeMins(int count, std::vector<rbNode *> &removed);
+
+  // remove the element with a given handle from the heap
+  void remove(int index);
+
+  // reorder the node of a ride after its cost or duration changed
+  void update(rbNode *ride);
+};
+
+#endif // PAIRINGHEAP_H
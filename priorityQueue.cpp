@@ -0,0 +1,58 @@
+#include "priorityQueue.hpp"
+#include "minHeap.hpp"
+#include "packedHeap.hpp"
+#include "pairingHeap.hpp"
+
+namespace {
+
+// A priority queue backed by one of the heaps, which forwards every call to
+// it. The heaps themselves have no virtual functions, so the engines that
+// take the heap as a template argument call them directly.
+template <typename Heap> class heapQueue : public priorityQueue {
+private:
+  Heap heap;
+
+public:
+  int getSize() const override { return heap.getSize(); }
+
+  void insert(rbNode *ride) override { heap.insert(ride); }
+
+  void bulkInsert(const std::vector<rbNode *> &rides) override {
+    heap.bulkInsert(rides);
+  }
+
+  rbNode *peekMin() override { return heap.peekMin(); }
+
+  rbNode *removeMin() override { return heap.removeMin(); }
+
+  int removeMins(int count, std::vector<rbNode *> &removed) override {
+    return heap.removeMins(count, removed);
+  }
+
+  void remove(int handle) override { heap.remove(handle); }
+
+  void update(rbNode *ride) override { heap.update(ride); }
+};
+
+} // namespace
+
+const char *const priorityQueueNames[3] = {"minheap", "packed", "pairing"};
+
+/**
+ * @brief Creates an empty priority queue of the named backend.
+ *
+ * @param name One of priorityQueueNames.
+ * @return The queue, or nullptr if no backend has that name.
+ */
+std::unique_ptr<priorityQueue> makePriorityQueue(const std::string &name) {
+  if (name == "minheap") {
+    return std::unique_ptr<priorityQueue>(new heapQueue<minHeap<4>>());
+  }
+  if (name == "packed") {
+    return std::unique_ptr<priorityQueue>(new heapQueue<packedHeap<8>>());
+  }
+  if (name == "pairing") {
+    return std::unique_ptr<priorityQueue>(new heapQueue<pairingHeap>());
+  }
+  return nullptr;
+}
@@ -0,0 +1,54 @@
+#ifndef PRIORITYQUEUE_H
+#define PRIORITYQUEUE_H
+
+#include "rbNode.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Interface of the priority queues of pending rides, so that the queue used
+// by gatorTaxi can be chosen at runtime. It has the operations shared by
+// minHeap, packedHeap and pairingHeap. Every backend keeps a handle in the
+// red black node of each ride it holds, which is what remove() takes, so
+// callers never need to know which backend they use.
+class priorityQueue {
+public:
+  virtual ~priorityQueue() {}
+
+  // get the number of rides in the queue
+  virtual int getSize() const = 0;
+
+  // insert the ride held by a red black node and link the two
+  virtual void insert(rbNode *ride) = 0;
+
+  // insert the rides of many red black nodes at once
+  virtual void bulkInsert(const std::vector<rbNode *> &rides) = 0;
+
+  // return the red black node of the best ride, or nullptr if there is none
+  virtual rbNode *peekMin() = 0;
+
+  // remove the best ride and return its red black node
+  // throws std::runtime_error if the queue is empty
+  virtual rbNode *removeMin() = 0;
+
+  // remove up to count best rides and append their red black nodes to
+  // removed in priority order, returning how many were removed
+  virtual int removeMins(int count, std::vector<rbNode *> &removed) = 0;
+
+  // remove the ride with the given handle
+  virtual void remove(int handle) = 0;
+
+  // reorder a ride after its cost or duration changed
+  virtual void update(rbNode *ride) = 0;
+};
+
+// Names of the backends accepted by makePriorityQueue, the first one is the
+// default: "minheap" is the 4-ary minHeap, "packed" the 8-ary packedHeap and
+// "pairing" the pairingHeap.
+extern const char *const priorityQueueNames[3];
+
+// Creates an empty queue of the named backend, or returns nullptr if there is
+// no backend of that name.
+std::unique_ptr<priorityQueue> makePriorityQueue(const std::string &name);
+
+#endif // PRIORITYQUEUE_H
@@ -1,38 +1,38 @@
 #include "rbNode.hpp"
-#include "heapNode.hpp"
-
-// Initialize the NIL node to have rideNumber, rideCost, and tripDuration of -1.
-rbNode rbNode::NIL = rbNode(-1, -1, -1);
 
 /**
  * @brief Constructor for rbNode class.
  *
- * @param rideNumber The ride number.
- * @param rideCost The cost of the ride.
- * @param tripDuration The duration of the trip.
+ * @details The links start out null. The tree owning the node points them at
+ * its sentinel before the node is used. A new node is a red leaf; the tree
+ * turns its sentinel black and empty.
+ *
+ * @param ride The ride held by the node.
  */
-rbNode::rbNode(int rideNumber, int rideCost, int tripDuration)
-    : rideNumber(rideNumber), rideCost(rideCost), tripDuration(tripDuration),
-      heapNodeRef(nullptr) {
-  setParent(&NIL);
-  setLeft(&NIL);
-  setRight(&NIL);
-
-  setColor(rideNumber == -1 ? nodeColor::BLACK : nodeColor::RED);
+template <typename Payload>
+basicRbNode<Payload>::basicRbNode(const Payload &ride)
+    : Payload(ride), heapHandle(0) {
+  setParent(nullptr);
+  setLeft(nullptr);
+  setRight(nullptr);
+
+  setColor(nodeColor::RED);
+  setSize(1);
 }
 
 /**
  *
  * @brief Destructor for rbNode class.
  */
-rbNode::~rbNode() {}
+template <typename Payload> basicRbNode<Payload>::~basicRbNode() {}
 
 /**
  * @brief Set the color of the node.
  *
  * @return nodeColor The color of the node.
  */
-nodeColor rbNode::getColor() const {
+template <typename Payload>
+nodeColor basicRbNode<Payload>::getColor() const {
   return color;
 }
 
@@ -41,26 +41,50 @@ nodeColor rbNode::getColor() const {
  *
  * @param newColor The new color of the node.
  */
-void rbNode::setColor(nodeColor newColor) {
+template <typename Payload>
+void basicRbNode<Payload>::setColor(nodeColor newColor) {
   color = newColor;
 }
 
 /**
- * @brief  Get the heap Node Reference of the node.
+ * @brief Get the number of nodes in the subtree rooted at this node.
+ *
+ * @return int The size of the subtree.
+ */
+template <typename Payload>
+int basicRbNode<Payload>::getSize() const {
+  return size;
+}
+
+/**
+ * @brief Set the number of nodes in the subtree rooted at this node.
  *
- * @return heapNode* Pointer to the heapNode associated with the red black Node.
+ * @param newSize The new size of the subtree.
  */
-heapNode *rbNode::getHeapNodeRef() const {
-  return heapNodeRef;
+template <typename Payload>
+void basicRbNode<Payload>::setSize(int newSize) {
+  size = newSize;
 }
 
 /**
- * @brief Set the heap Node Reference of the node.
+ * @brief  Get the handle of the ride in the priority queue.
  *
- * @param  newHeapNodeRef The new heapNode to associate with the red black Node.
+ * @return int Index of the heap slot or pairing heap node of the ride.
  */
-void rbNode::setHeapNodeRef(heapNode *newHeapNodeRef) {
-  heapNodeRef = newHeapNodeRef;
+template <typename Payload>
+int basicRbNode<Payload>::getHeapHandle() const {
+  return heapHandle;
+}
+
+/**
+ * @brief Set the handle of the ride in the priority queue.
+ *
+ * @param  newHeapHandle The new index of the heap slot or pairing heap node of
+ * the ride.
+ */
+template <typename Payload>
+void basicRbNode<Payload>::setHeapHandle(int newHeapHandle) {
+  heapHandle = newHeapHandle;
 }
 
 /**
@@ -68,7 +92,8 @@ void rbNode::setHeapNodeRef(heapNode *newHeapNodeRef) {
  *
  * @return rbNode* Pointer to the parent of the node.
  */
-rbNode *rbNode::getParent() const {
+template <typename Payload>
+basicRbNode<Payload> *basicRbNode<Payload>::getParent() const {
   return parent;
 }
 
@@ -77,7 +102,8 @@ rbNode *rbNode::getParent() const {
  *
  * @param  newParent Pointer to the new parent node.
  */
-void rbNode::setParent(rbNode *newParent) {
+template <typename Payload>
+void basicRbNode<Payload>::setParent(basicRbNode *newParent) {
   parent = newParent;
 }
 
@@ -86,7 +112,8 @@ void rbNode::setParent(rbNode *newParent) {
  *
  * @return  rbNode* Pointer to the left child of the node.
  */
-rbNode *rbNode::getLeft() const {
+template <typename Payload>
+basicRbNode<Payload> *basicRbNode<Payload>::getLeft() const {
   return left;
 }
 
@@ -95,7 +122,8 @@ rbNode *rbNode::getLeft() const {
  *
  * @param newLeft Pointer to the new left child node.
  */
-void rbNode::setLeft(rbNode *newLeft) {
+template <typename Payload>
+void basicRbNode<Payload>::setLeft(basicRbNode *newLeft) {
   left = newLeft;
 }
 
@@ -104,7 +132,8 @@ void rbNode::setLeft(rbNode *newLeft) {
  *
  * @return rbNode* Pointer to the right child of the node.
  */
-rbNode *rbNode::getRight() const {
+template <typename Payload>
+basicRbNode<Payload> *basicRbNode<Payload>::getRight() const {
   return right;
 }
 
@@ -113,7 +142,8 @@ rbNode *rbNode::getRight() const {
  *
  * @param Set the right child of the node.
  */
-void rbNode::setRight(rbNode *newRight) {
+template <typename Payload>
+void basicRbNode<Payload>::setRight(basicRbNode *newRight) {
   right = newRight;
 }
 
@@ -124,8 +154,13 @@ void rbNode::setRight(rbNode *newRight) {
  * @param node The red black tree node object to insert into the stream.
  * @return std::ostream& A reference to the output stream.
  */
-std::ostream &operator<<(std::ostream &os, const rbNode &node) {
+template <typename Payload>
+std::ostream &operator<<(std::ostream &os, const basicRbNode<Payload> &node) {
   os << '(' << node.rideNumber << "," << node.rideCost << ","
      << node.tripDuration << ')';
   return os;
-}
\ No newline at end of file
+}
+
+// Payloads available to the rest of the program.
+template class basicRbNode<rideInfo>;
+template std::ostream &operator<<(std::ostream &, const rbNode &);
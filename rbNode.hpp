@@ -1,52 +1,58 @@
 #ifndef RBNODE_H
 #define RBNODE_H
 
+#include "rideTypes.hpp"
 #include <iostream>
 
 // Enum for the possible colors of a node in a red-black tree.
 enum class nodeColor { RED, BLACK };
 
-// Forward declaration of the heapNode class, since it is used in the rbNode
-// class.
-class heapNode;
-
-// Class representing a node in a red-black tree.
-class rbNode {
+// Class representing a node in a red-black tree. The node derives from the
+// payload it holds, so the fields of the ride are members of the node. The
+// member functions are instantiated in rbNode.cpp for rideInfo.
+template <typename Payload> class basicRbNode : public Payload {
 private:
-  rbNode *left, *right, *parent; // Pointers to the left child, right child, and
-                                 // parent of the node.
-  heapNode *heapNodeRef; // Pointer to the corresponding node in the heap.
-  nodeColor color;       // Color of the node.
+  int heapHandle; // Handle of the ride in the priority queue: its slot in an
+                  // array heap or its node in the pairing heap. An index
+                  // stays valid when the queue grows, a pointer does not.
+  basicRbNode *left, *right, *parent; // Pointers to the left child, right
+                                      // child, and parent of the node.
+  nodeColor color;                    // Color of the node.
+  int size; // Number of nodes in the subtree rooted at this node, 0 for the
+            // sentinel.
 
 public:
-  // Data values held by the node.
-  int rideNumber, rideCost, tripDuration;
-
-  // Static sentinel node to represent a null node in the tree.
-  static rbNode NIL;
+  using payloadType = Payload;
 
   // Constructor and destructor.
-  rbNode(int rideNumber, int rideCost, int tripDuration);
-  ~rbNode();
+  explicit basicRbNode(const Payload &ride);
+  ~basicRbNode();
 
   // Getters and setters for private member variables.
   nodeColor getColor() const;
   void setColor(nodeColor newColor);
 
-  heapNode *getHeapNodeRef() const;
-  void setHeapNodeRef(heapNode *newHeapNodeRef);
+  int getSize() const;
+  void setSize(int newSize);
 
-  rbNode *getParent() const;
-  void setParent(rbNode *newParent);
+  int getHeapHandle() const;
+  void setHeapHandle(int newHeapHandle);
 
-  rbNode *getLeft() const;
-  void setLeft(rbNode *newLeft);
+  basicRbNode *getParent() const;
+  void setParent(basicRbNode *newParent);
 
-  rbNode *getRight() const;
-  void setRight(rbNode *newRight);
+  basicRbNode *getLeft() const;
+  void setLeft(basicRbNode *newLeft);
 
-  // Overloaded output operator to print out the node.
-  friend std::ostream &operator<<(std::ostream &os, const rbNode &node);
+  basicRbNode *getRight() const;
+  void setRight(basicRbNode *newRight);
 };
 
-#endif // RBNODE_H
\ No newline at end of file
+// The node of GatorTaxi's rides.
+using rbNode = basicRbNode<rideInfo>;
+
+// Overloaded output operator to print out a node.
+template <typename Payload>
+std::ostream &operator<<(std::ostream &os, const basicRbNode<Payload> &node);
+
+#endif // RBNODE_H
@@ -0,0 +1,111 @@
+#include "rbNodePool.hpp"
+#include <new>
+
+/**
+ * @brief Constructor for rbNodePool class.
+ *
+ * @details No chunk is requested until the first node is allocated.
+ */
+template <typename Payload>
+basicRbNodePool<Payload>::basicRbNodePool()
+    : freeList(nullptr), nextUnused(chunkSize), allocations(0), recycled(0),
+      liveNodes(0) {}
+
+/**
+ * @brief Destructor for rbNodePool class.
+ *
+ * @details Releases every chunk, including the nodes that are still in use.
+ */
+template <typename Payload> basicRbNodePool<Payload>::~basicRbNodePool() {
+  for (rbNode *chunk : chunks) {
+    ::operator delete(chunk);
+  }
+}
+
+/**
+ * @brief Hands out a node holding the given ride.
+ *
+ * @details A recycled node is used if one is available, otherwise the node is
+ * carved out of the newest chunk. A new chunk is requested from the system
+ * allocator only when the newest one is exhausted.
+ *
+ * @param ride The ride held by the node.
+ * @return rbNode* Pointer to the constructed node.
+ */
+template <typename Payload>
+basicRbNode<Payload> *basicRbNodePool<Payload>::allocate(const Payload &ride) {
+  rbNode *memory;
+
+  if (freeList != nullptr) {
+    // Reuse the most recently released node.
+    memory = freeList;
+    freeList = freeList->getParent();
+    recycled++;
+  } else {
+    if (nextUnused == chunkSize) {
+      chunks.push_back(
+          static_cast<rbNode *>(::operator new(sizeof(rbNode) * chunkSize)));
+      nextUnused = 0;
+    }
+    memory = chunks.back() + nextUnused++;
+  }
+
+  allocations++;
+  liveNodes++;
+  return new (memory) rbNode(ride);
+}
+
+/**
+ * @brief Returns a node to the pool so that it can be recycled.
+ *
+ * @param node Pointer to a node previously handed out by this pool.
+ */
+template <typename Payload>
+void basicRbNodePool<Payload>::release(rbNode *node) {
+  node->setParent(freeList);
+  freeList = node;
+  liveNodes--;
+}
+
+/**
+ * @brief Get the number of chunks requested from the system allocator.
+ *
+ * @return int The number of chunks.
+ */
+template <typename Payload>
+int basicRbNodePool<Payload>::getChunkCount() const {
+  return chunks.size();
+}
+
+/**
+ * @brief Get the number of nodes handed out since the pool was created.
+ *
+ * @return long long The number of allocations.
+ */
+template <typename Payload>
+long long basicRbNodePool<Payload>::getAllocationCount() const {
+  return allocations;
+}
+
+/**
+ * @brief Get the number of allocations served from the free list.
+ *
+ * @return long long The number of recycled nodes.
+ */
+template <typename Payload>
+long long basicRbNodePool<Payload>::getRecycledCount() const {
+  return recycled;
+}
+
+/**
+ * @brief Get the number of nodes currently in use.
+ *
+ * @return int The number of live nodes.
+ */
+template <typename Payload>
+int basicRbNodePool<Payload>::getLiveCount() const {
+  return liveNodes;
+}
+
+// Payloads available to the rest of the program.
+template class basicRbNodePool<rideInfo>;
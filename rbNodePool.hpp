@@ -0,0 +1,52 @@
+#ifndef RBNODEPOOL_H
+#define RBNODEPOOL_H
+
+#include "rbNode.hpp"
+#include <vector>
+
+// Slab allocator for red black tree nodes holding the given payload. Nodes
+// are handed out from contiguous chunks, and released nodes are recycled
+// through a free list before any new chunk is requested. The member
+// functions are instantiated in rbNodePool.cpp for rideInfo.
+template <typename Payload> class basicRbNodePool {
+private:
+  using rbNode = basicRbNode<Payload>;
+
+  // Number of nodes carved out of every chunk.
+  static const int chunkSize = 1024;
+
+  std::vector<rbNode *> chunks; // Chunks obtained from the system allocator.
+  rbNode *freeList;             // Released nodes, linked through their parent
+                                // pointer.
+  int nextUnused;               // Index of the first never used node in the
+                                // newest chunk.
+
+  // Counters describing the behaviour of the pool.
+  long long allocations, recycled;
+  int liveNodes;
+
+public:
+  // Constructor and destructor. The destructor releases every chunk.
+  basicRbNodePool();
+  ~basicRbNodePool();
+
+  basicRbNodePool(const basicRbNodePool &) = delete;
+  basicRbNodePool &operator=(const basicRbNodePool &) = delete;
+
+  // Hands out a node holding the given ride.
+  rbNode *allocate(const Payload &ride);
+
+  // Returns a node to the pool so that it can be recycled.
+  void release(rbNode *node);
+
+  // Getters for the pool counters.
+  int getChunkCount() const;
+  long long getAllocationCount() const;
+  long long getRecycledCount() const;
+  int getLiveCount() const;
+};
+
+// The pool of GatorTaxi's nodes.
+using rbNodePool = basicRbNodePool<rideInfo>;
+
+#endif // RBNODEPOOL_H
@@ -1,22 +1,46 @@
 #include "rbTree.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 /**
  * @brief Constructor for rbTree class
- * @details Initializes the nil and root pointers and sets the left and right
- * children of root to nil.
+ * @details Initializes the nil and root pointers to the sentinel of the tree,
+ * links the sentinel to itself and makes it a black node of size 0.
  */
-rbTree::rbTree() {
-  nil = &rbNode::NIL;
+template <typename Key, typename Payload, typename Order>
+basicRbTree<Key, Payload, Order>::basicRbTree() : sentinel(Payload()) {
+  nil = &sentinel;
   root = nil;
-  root->setLeft(nil);
-  root->setRight(nil);
+  nil->setParent(nil);
+  nil->setLeft(nil);
+  nil->setRight(nil);
+  nil->setColor(nodeColor::BLACK);
+  nil->setSize(0);
 }
 
 /**
  * @brief Destructor for rbTree class.
+ *
+ * @details The node pool releases the memory of every node of the tree.
  */
-rbTree::~rbTree() {}
+template <typename Key, typename Payload, typename Order>
+basicRbTree<Key, Payload, Order>::~basicRbTree() {}
+
+/**
+ * @brief Creates a node for the given ride from the node pool of the tree.
+ *
+ * @param ride The ride held by the node.
+ * @return Pointer to the new node, which is not yet linked into the tree.
+ */
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::nodeType *
+basicRbTree<Key, Payload, Order>::createNode(const Payload &ride) {
+  nodeType *node = pool.allocate(ride);
+  node->setParent(nil);
+  node->setLeft(nil);
+  node->setRight(nil);
+  return node;
+}
 
 /**
  * @brief Checks if a node is a left child of its parent.
@@ -24,7 +48,8 @@ rbTree::~rbTree() {}
  * @param node The node to be checked.
  * @return true if node is a left child of its parent, false otherwise.
  */
-bool rbTree::isLeftChild(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+bool basicRbTree<Key, Payload, Order>::isLeftChild(nodeType *node) {
   return node == (node->getParent())->getLeft();
 }
 
@@ -34,7 +59,8 @@ bool rbTree::isLeftChild(rbNode *node) {
  * @param node The node to be checked.
  * @return true if node is a right child of its parent, false otherwise.
  */
-bool rbTree::isRightChild(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+bool basicRbTree<Key, Payload, Order>::isRightChild(nodeType *node) {
   return node == (node->getParent())->getRight();
 }
 
@@ -45,8 +71,10 @@ bool rbTree::isRightChild(rbNode *node) {
  * @param oldChild The child node to be replaced.
  * @param newChild The new child node to be updated.
  **/
-void rbTree::UpdateParentChildLink(rbNode *parent, rbNode *oldChild,
-                                   rbNode *newChild) {
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::UpdateParentChildLink(nodeType *parent,
+                                                     nodeType *oldChild,
+                                                     nodeType *newChild) {
   // Set parent as new-child's parent.
   newChild->setParent(parent);
 
@@ -59,14 +87,26 @@ void rbTree::UpdateParentChildLink(rbNode *parent, rbNode *oldChild,
   }
 }
 
+/**
+ * @brief Recomputes the subtree size of a node from the sizes of its children.
+ *
+ * @param node The node to be updated.
+ **/
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::updateSize(nodeType *node) {
+  node->setSize((node->getLeft())->getSize() + (node->getRight())->getSize() +
+                1);
+}
+
 /**
  * @brief Performs a right rotation on the given node.
  *
  * @param node The node to be rotated right.
  **/
-void rbTree::rotateRight(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::rotateRight(nodeType *node) {
   // Get the left child of the input node
-  rbNode *Y_Node = node->getLeft();
+  nodeType *Y_Node = node->getLeft();
 
   // Set the left child of the input node to the right child of Y_Node
   node->setLeft(Y_Node->getRight());
@@ -82,6 +122,10 @@ void rbTree::rotateRight(rbNode *node) {
   // Perform the right rotation
   Y_Node->setRight(node);
   node->setParent(Y_Node);
+
+  // Y_Node now roots the subtree that node rooted before
+  Y_Node->setSize(node->getSize());
+  updateSize(node);
 }
 
 /**
@@ -89,9 +133,10 @@ void rbTree::rotateRight(rbNode *node) {
  *
  * @param node The node to be rotated left.
  **/
-void rbTree::rotateLeft(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::rotateLeft(nodeType *node) {
   // Get the right child of the input node
-  rbNode *Y_Node = node->getRight();
+  nodeType *Y_Node = node->getRight();
 
   // Set the right child of the input node to the left child of Y_Node
   node->setRight(Y_Node->getLeft());
@@ -107,6 +152,10 @@ void rbTree::rotateLeft(rbNode *node) {
   // Perform the left rotation
   Y_Node->setLeft(node);
   node->setParent(Y_Node);
+
+  // Y_Node now roots the subtree that node rooted before
+  Y_Node->setSize(node->getSize());
+  updateSize(node);
 }
 
 /**
@@ -114,8 +163,9 @@ void rbTree::rotateLeft(rbNode *node) {
  *
  * @param node A pointer to the node that was inserted.
  */
-void rbTree::insertionRebalance(rbNode *node) {
-  rbNode *Y_Node = nullptr;
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::insertionRebalance(nodeType *node) {
+  nodeType *Y_Node = nullptr;
 
   // Loop until the parent of the input node is red
   while ((node->getParent())->getColor() == nodeColor::RED) {
@@ -189,21 +239,23 @@ void rbTree::insertionRebalance(rbNode *node) {
  * @param node The node to be inserted into the tree.
  * @throw std::runtime_error If the key value already exists in the tree.
  **/
-void rbTree::insert(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::insert(nodeType *node) {
   if (node == nullptr) {
     throw std::runtime_error("The node isn't a valid node\n");
   }
 
-  rbNode *X_Node = root, *Y_Node = nil;
+  nodeType *X_Node = root, *Y_Node = nil;
+  Key key = Order::key(*node);
 
   // finding the position where this node should be added in red black tree by
   // binary tree properties
   while (X_Node != nil) {
     Y_Node = X_Node;
 
-    if (node->rideNumber < X_Node->rideNumber) {
+    if (Order::less(key, Order::key(*X_Node))) {
       X_Node = X_Node->getLeft();
-    } else if (node->rideNumber > X_Node->rideNumber) {
+    } else if (Order::less(Order::key(*X_Node), key)) {
       X_Node = X_Node->getRight();
     } else {
       throw std::runtime_error("Duplicate RideNumber\n");
@@ -215,25 +267,230 @@ void rbTree::insert(rbNode *node) {
   // Inserts the node at appropriate position by binary tree properties.
   if (Y_Node == nil) {
     root = node;
-  } else if (node->rideNumber < Y_Node->rideNumber) {
+  } else if (Order::less(key, Order::key(*Y_Node))) {
     Y_Node->setLeft(node);
-  } else if (node->rideNumber > Y_Node->rideNumber) {
+  } else {
     Y_Node->setRight(node);
-  } else if (node->rideNumber == Y_Node->rideNumber) {
-    throw std::runtime_error("Duplicate RideNumber\n");
+  }
+
+  // Every ancestor of the new node gains one node in its subtree
+  for (nodeType *ancestor = Y_Node; ancestor != nil;
+       ancestor = ancestor->getParent()) {
+    ancestor->setSize(ancestor->getSize() + 1);
   }
 
   // Rebalancing the tree after insertion
   insertionRebalance(node);
 }
 
+/**
+ * @brief Appends the nodes of the tree to a vector in ride number order.
+ *
+ * @param nodes The vector receiving the nodes.
+ **/
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::collectNodes(
+    std::vector<nodeType *> &nodes) {
+  nodeType *pending[maxHeight];
+  int depth = 0;
+  nodeType *node = root;
+
+  while (node != nil || depth > 0) {
+    // Go down the left side first, remembering the nodes passed
+    for (; node != nil; node = node->getLeft()) {
+      pending[depth++] = node;
+    }
+    node = pending[--depth];
+    nodes.push_back(node);
+    node = node->getRight();
+  }
+}
+
+/**
+ * @brief Builds a balanced subtree from a sorted range of nodes.
+ * The middle node becomes the root of the subtree and both halves are built
+ * recursively, so the sizes of sibling subtrees differ by at most one and
+ * every level except the deepest one is full. Coloring the deepest level red
+ * and all others black therefore gives every path the same black height.
+ *
+ * @param nodes The nodes sorted by ride number.
+ * @param first Index of the first node of the subtree.
+ * @param last Index of the last node of the subtree.
+ * @param depth Depth of the root of the subtree.
+ * @param redDepth Depth of the nodes to be colored red.
+ * @param parent The parent of the root of the subtree.
+ * @return The root of the subtree, nil for an empty range.
+ **/
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::nodeType *
+basicRbTree<Key, Payload, Order>::buildBalanced(std::vector<nodeType *> &nodes,
+                                                int first, int last, int depth,
+                                                int redDepth,
+                                                nodeType *parent) {
+  if (first > last) {
+    return nil;
+  }
+
+  int middle = first + (last - first) / 2;
+  nodeType *node = nodes[middle];
+
+  node->setParent(parent);
+  node->setLeft(
+      buildBalanced(nodes, first, middle - 1, depth + 1, redDepth, node));
+  node->setRight(
+      buildBalanced(nodes, middle + 1, last, depth + 1, redDepth, node));
+  node->setColor(depth == redDepth ? nodeColor::RED : nodeColor::BLACK);
+  node->setSize(last - first + 1);
+
+  return node;
+}
+
+/**
+ * @brief Inserts a batch of nodes by rebuilding the tree bottom-up.
+ * The batch is sorted and merged with the nodes already in the tree, then the
+ * whole tree is rebuilt as a balanced, correctly colored tree. This takes
+ * O(n + m log m) for n nodes in the tree and m new nodes, or O(n + m) if the
+ * batch is already sorted, instead of the O(m log(n + m)) rebalancing steps
+ * of inserting one node at a time.
+ *
+ * @param nodes The nodes to be inserted, which are sorted in place.
+ * @throw std::runtime_error If a ride number appears twice in the batch or
+ * already exists in the tree. The tree is left unchanged.
+ **/
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::bulkInsert(
+    std::vector<nodeType *> &nodes) {
+  if (nodes.empty()) {
+    return;
+  }
+  auto byKey = [](const nodeType *a, const nodeType *b) {
+    return Order::less(Order::key(*a), Order::key(*b));
+  };
+
+  // Batches loaded from a snapshot are already in order, which keeps the
+  // whole load linear.
+  if (!std::is_sorted(nodes.begin(), nodes.end(), byKey)) {
+    std::sort(nodes.begin(), nodes.end(), byKey);
+  }
+
+  std::vector<nodeType *> existing;
+  existing.reserve(getSize());
+  collectNodes(existing);
+
+  // Merge the batch with the nodes of the tree, checking for duplicates
+  // before anything is relinked.
+  std::vector<nodeType *> merged;
+  merged.reserve(existing.size() + nodes.size());
+
+  std::size_t i = 0, j = 0;
+  while (i < existing.size() || j < nodes.size()) {
+    // Two ride numbers are equal when neither is below the other.
+    if (j == nodes.size() ||
+        (i < existing.size() && byKey(existing[i], nodes[j]))) {
+      merged.push_back(existing[i++]);
+    } else if (!merged.empty() && !byKey(merged.back(), nodes[j])) {
+      throw std::runtime_error("Duplicate RideNumber\n");
+    } else if (i < existing.size() && !byKey(nodes[j], existing[i])) {
+      throw std::runtime_error("Duplicate RideNumber\n");
+    } else {
+      merged.push_back(nodes[j++]);
+    }
+  }
+
+  rebuild(merged);
+}
+
+/**
+ * @brief Deletes a batch of nodes from the tree and recycles them.
+ * A batch that is large compared to the tree is removed by filtering the
+ * nodes of the tree in order and rebuilding it, which takes O(n + m log m)
+ * instead of m separate deletions with their rebalancing. Smaller batches are
+ * deleted one node at a time.
+ *
+ * @param nodes The nodes to be deleted, which are sorted in place.
+ **/
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::deleteNodes(
+    std::vector<nodeType *> &nodes) {
+  if (8 * nodes.size() < getSize()) {
+    for (nodeType *node : nodes) {
+      deleteNode(node);
+    }
+    return;
+  }
+
+  auto byKey = [](const nodeType *a, const nodeType *b) {
+    return Order::less(Order::key(*a), Order::key(*b));
+  };
+  std::sort(nodes.begin(), nodes.end(), byKey);
+
+  std::vector<nodeType *> existing;
+  existing.reserve(getSize());
+  collectNodes(existing);
+
+  // Both lists are in ride number order, so the nodes to keep are found in
+  // one merging pass.
+  std::vector<nodeType *> kept;
+  kept.reserve(existing.size() - nodes.size());
+
+  std::size_t next = 0;
+  for (nodeType *node : existing) {
+    if (next < nodes.size() && nodes[next] == node) {
+      next++;
+    } else {
+      kept.push_back(node);
+    }
+  }
+
+  rebuild(kept);
+
+  for (nodeType *node : nodes) {
+    pool.release(node);
+  }
+}
+
+/**
+ * @brief Replaces the tree by a balanced tree of the given nodes.
+ *
+ * @param nodes All nodes of the new tree, sorted by ride number.
+ **/
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::rebuild(std::vector<nodeType *> &nodes) {
+  if (nodes.empty()) {
+    root = nil;
+    return;
+  }
+
+  // The deepest level of a balanced tree of n nodes is floor(log2(n)). The
+  // root stays black even if it is the only level.
+  int redDepth = 0;
+  while ((2u << redDepth) <= nodes.size()) {
+    redDepth++;
+  }
+
+  root = buildBalanced(nodes, 0, nodes.size() - 1, 0, redDepth, nil);
+  root->setColor(nodeColor::BLACK);
+}
+
+/**
+ * @brief Returns a node that is not linked into the tree to the node pool.
+ *
+ * @param node The node to be recycled.
+ **/
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::destroyNode(nodeType *node) {
+  pool.release(node);
+}
+
 /**
  * @brief Finds minimum node under the given node.
  *
  * @param node: The root node from which to find the minimum node.
  * @return The minimum node in the subtree rooted at node.
  **/
-rbNode *rbTree::getMinimumNode(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::nodeType *
+basicRbTree<Key, Payload, Order>::getMinimumNode(nodeType *node) {
   while (node->getLeft() != nil) {
     node = node->getLeft();
   }
@@ -245,9 +502,10 @@ rbNode *rbTree::getMinimumNode(rbNode *node) {
  *
  * @param node the node that was deleted.
  */
-void rbTree::DeletionRebalance(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::DeletionRebalance(nodeType *node) {
   while (node != root && node->getColor() == nodeColor::BLACK) {
-    rbNode *sibling;
+    nodeType *sibling;
     if (isLeftChild(node)) {
       // Get the sibling of the node
       sibling = (node->getParent())->getRight();
@@ -330,19 +588,32 @@ void rbTree::DeletionRebalance(rbNode *node) {
  * It first checks if the given node is valid or not, and then it deletes the
  * node by either replacing it with its right child or left child or minimum
  * node from the right subtree of the node. After deleting the node, it
- * rebalances the tree by calling DeletionRebalance function.
+ * rebalances the tree by calling DeletionRebalance function and returns the
+ * node to the node pool, so it must not be used afterwards.
  *
  * @param node Pointer to the node to be deleted.
  * @throws std::runtime_error if the node is not a valid node.
  */
-void rbTree::deleteNode(rbNode *node) {
+template <typename Key, typename Payload, typename Order>
+void basicRbTree<Key, Payload, Order>::deleteNode(nodeType *node) {
   if (node == nullptr) {
     throw std::runtime_error("The node isn't a valid node\n");
   }
 
-  rbNode *X_Node = nullptr, *Y_Node = node;
+  nodeType *X_Node = nullptr, *Y_Node = node;
   nodeColor NodeColor = Y_Node->getColor();
 
+  // The node that leaves its position is the node itself, or its successor
+  // if it has two children. Every ancestor of that position loses one node.
+  nodeType *removed = node;
+  if (node->getLeft() != nil && node->getRight() != nil) {
+    removed = getMinimumNode(node->getRight());
+  }
+  for (nodeType *ancestor = removed->getParent(); ancestor != nil;
+       ancestor = ancestor->getParent()) {
+    ancestor->setSize(ancestor->getSize() - 1);
+  }
+
   if (node->getLeft() ==
       nil) { // Handle case when the node has only right child or no child
     X_Node = node->getRight();
@@ -370,112 +641,291 @@ void rbTree::deleteNode(rbNode *node) {
     (Y_Node->getLeft())->setParent(Y_Node);
     Y_Node->setColor(node->getColor()); // Set minimum node's color same as that
                                         // of node being deleted
+    Y_Node->setSize(node->getSize());   // and its subtree size
   }
 
   if (NodeColor == nodeColor::BLACK) {
     DeletionRebalance(X_Node);
   }
+
+  pool.release(node);
 }
 
 /**
- * @brief Recursive search for a node with a given ride number.
- * Given the root node and a ride number, this function recursively searches the
- * red-black tree for the node with the given ride number. It returns the node
- * pointer if it is found, otherwise it returns nullptr.
+ * @brief Search for a node with a given ride number.
+ * Given a ride number, this function walks down the red-black tree from the
+ * root, going left while the ride number is smaller than the one of the
+ * current node and right while it is greater, until it finds the node or falls
+ * off the tree. The walk is a loop, so it needs no stack frame per level.
  *
- * @param root Pointer to the root node of the tree.
  * @param rideNumber The ride number to be searched.
  * @return Pointer to the node with the given ride number if it is found,
  * otherwise nullptr.
  */
-rbNode *rbTree::searchRecursive(rbNode *root, int rideNumber) {
-  if (root == nil) {
-    return nullptr;
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::nodeType *
+basicRbTree<Key, Payload, Order>::search(Key rideNumber) {
+  nodeType *current = root;
+  while (current != nil) {
+    if (Order::less(rideNumber, Order::key(*current))) {
+      current = current->getLeft();
+    } else if (Order::less(Order::key(*current), rideNumber)) {
+      current = current->getRight();
+    } else {
+      return current;
+    }
   }
+  return nullptr;
+}
+
+/**
+ * @brief Returns the number of nodes in the tree.
+ *
+ * @return The subtree size of the root.
+ */
+template <typename Key, typename Payload, typename Order>
+int basicRbTree<Key, Payload, Order>::getSize() const {
+  return root->getSize();
+}
 
-  if (root->rideNumber == rideNumber) { // if node found then return
-    return root;
-  } else if (root->rideNumber >
-             rideNumber) { // if root' ridenumber is greater than given
-                           // ridenumber then look in left side
-    return searchRecursive(root->getLeft(), rideNumber);
-  } else { // if root' ridenumber is lesser than given
-           // ridenumber then look in right side
-    return searchRecursive(root->getRight(), rideNumber);
+/**
+ * @brief Counts the nodes with a ride number below a bound.
+ * Descends from the root towards the bound and adds up the left subtrees
+ * passed on the way, which takes O(log n) steps.
+ *
+ * @param rideNumber The bound.
+ * @param inclusive Whether a node equal to the bound is counted.
+ * @return The number of nodes below the bound.
+ */
+template <typename Key, typename Payload, typename Order>
+int basicRbTree<Key, Payload, Order>::countBelow(Key rideNumber,
+                                                bool inclusive) const {
+  const nodeType *node = root;
+  int count = 0;
+
+  while (node != nil) {
+    if (inclusive ? !Order::less(rideNumber, Order::key(*node))
+                  : Order::less(Order::key(*node), rideNumber)) {
+      // node and its left subtree are below the bound
+      count += (node->getLeft())->getSize() + 1;
+      node = node->getRight();
+    } else {
+      node = node->getLeft();
+    }
   }
+
+  return count;
 }
 
 /**
- * @brief Search for a node with a given ride number.
- * Given a ride number, this function searches the red-black tree for the node
- * with the given ride number by calling searchRecursive function. It returns
- * the node pointer if it is found, otherwise it returns nullptr.
+ * @brief Counts the nodes with ride numbers within a given range.
  *
- * @param rideNumber The ride number to be searched.
- * @return Pointer to the node with the given ride number if it is found,
- * otherwise nullptr.
+ * @param rideNumber1 The lower bound of the range of ride numbers.
+ * @param rideNumber2 The upper bound of the range of ride numbers.
+ * @return The number of nodes in the range, 0 for an empty range.
  */
-rbNode *rbTree::search(int rideNumber) {
-  return searchRecursive(root, rideNumber);
+template <typename Key, typename Payload, typename Order>
+int basicRbTree<Key, Payload, Order>::countInRange(Key rideNumber1,
+                                                  Key rideNumber2) const {
+  if (Order::less(rideNumber2, rideNumber1)) {
+    return 0;
+  }
+  return countBelow(rideNumber2, true) - countBelow(rideNumber1, false);
 }
 
 /**
- * @brief Recursive search for nodes within a given range.
- * Given the root node, two ride numbers, and a vector to store the nodes, this
- * function recursively searches the red-black tree for the nodes with the ride
- * numbers within the given range. It adds the nodes found within the range to
- * the vector passed by reference. This function is called by searchInRange
- * function.
+ * @brief Finds the node with the k-th smallest ride number.
  *
- * @param root Pointer to the root node of the tree.
- * @param rideNumber1 The lower bound of the range of ride numbers to be
- * searched.
- * @param rideNumber2 The upper bound of the range of ride numbers to be
- * searched.
- * @param vec A vector to store the nodes found within the range.
+ * @param k The position of the node in ride number order, counting from 1.
+ * @return Pointer to the node, or nullptr if k is out of range.
  */
-void rbTree::searchInRangeRecursive(rbNode *root, int rideNumber1,
-                                    int rideNumber2, std::vector<rbNode> &vec) {
-  if (root == nil) {
-    return;
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::nodeType *
+basicRbTree<Key, Payload, Order>::select(int k) const {
+  nodeType *node = root;
+
+  while (node != nil) {
+    int leftSize = (node->getLeft())->getSize();
+
+    if (k <= leftSize) { // the node is in the left subtree
+      node = node->getLeft();
+    } else if (k == leftSize + 1) {
+      return node;
+    } else { // skip the left subtree and the node itself
+      k -= leftSize + 1;
+      node = node->getRight();
+    }
   }
 
-  if (root->rideNumber > rideNumber1) {
-    // if root's ridenumber is greater than given
-    // ridenumber then look in left side
-    searchInRangeRecursive(root->getLeft(), rideNumber1, rideNumber2, vec);
+  return nullptr;
+}
+
+/**
+ * @brief Returns the number of nodes with a ride number not above the given
+ * one. For a ride in the tree, this is its position in ride number order.
+ *
+ * @param rideNumber The ride number.
+ * @return The rank of the ride number.
+ */
+template <typename Key, typename Payload, typename Order>
+int basicRbTree<Key, Payload, Order>::rank(Key rideNumber) const {
+  return countBelow(rideNumber, true);
+}
+
+/**
+ * @brief Constructor for the in-order iterator.
+ *
+ * @param node The node the iterator points to, nil for the end.
+ * @param nil The sentinel node of the tree.
+ */
+template <typename Key, typename Payload, typename Order>
+basicRbTree<Key, Payload, Order>::iterator::iterator(const nodeType *node,
+                                                  const nodeType *nil)
+    : node(node), nil(nil) {}
+
+/**
+ * @brief Dereferences the iterator.
+ *
+ * @return A const reference to the current node.
+ */
+template <typename Key, typename Payload, typename Order>
+const typename basicRbTree<Key, Payload, Order>::nodeType &
+basicRbTree<Key, Payload, Order>::iterator::operator*() const {
+  return *node;
+}
+
+/**
+ * @brief Accesses the members of the current node.
+ *
+ * @return A const pointer to the current node.
+ */
+template <typename Key, typename Payload, typename Order>
+const typename basicRbTree<Key, Payload, Order>::nodeType *
+basicRbTree<Key, Payload, Order>::iterator::operator->() const {
+  return node;
+}
+
+/**
+ * @brief Moves the iterator to the in-order successor of the current node.
+ * The successor is the minimum of the right subtree if there is one, and
+ * otherwise the first ancestor reached from its left subtree.
+ *
+ * @return A reference to this iterator.
+ */
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::iterator &
+basicRbTree<Key, Payload, Order>::iterator::operator++() {
+  if (node->getRight() != nil) {
+    node = node->getRight();
+    while (node->getLeft() != nil) {
+      node = node->getLeft();
+    }
+  } else {
+    const nodeType *parent = node->getParent();
+    while (parent != nil && node == parent->getRight()) {
+      node = parent;
+      parent = parent->getParent();
+    }
+    node = parent;
   }
+  return *this;
+}
 
-  if (root->rideNumber >= rideNumber1 && root->rideNumber <= rideNumber2) {
-    // if found then insert in vector of rbNode pointers
-    rbNode inRangeNode = *root;
-    vec.push_back(inRangeNode);
+/**
+ * @brief Compares two iterators.
+ *
+ * @param other The iterator to compare against.
+ * @return True if both iterators point to the same node, false otherwise.
+ */
+template <typename Key, typename Payload, typename Order>
+bool basicRbTree<Key, Payload, Order>::iterator::operator==(
+    const iterator &other) const {
+  return node == other.node;
+}
+
+/**
+ * @brief Compares two iterators.
+ *
+ * @param other The iterator to compare against.
+ * @return True if the iterators point to different nodes, false otherwise.
+ */
+template <typename Key, typename Payload, typename Order>
+bool basicRbTree<Key, Payload, Order>::iterator::operator!=(
+    const iterator &other) const {
+  return node != other.node;
+}
+
+/**
+ * @brief Finds the first node with a ride number not less than the given one.
+ *
+ * @param rideNumber The ride number to look for.
+ * @return An iterator to the node found, or end() if there is none.
+ */
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::iterator
+basicRbTree<Key, Payload, Order>::lowerBound(Key rideNumber) const {
+  const nodeType *node = root, *candidate = nil;
+
+  while (node != nil) {
+    if (!Order::less(Order::key(*node),
+                     rideNumber)) { // node qualifies, look for a smaller one
+                                    // on the left side
+      candidate = node;
+      node = node->getLeft();
+    } else {
+      node = node->getRight();
+    }
   }
 
-  if (root->rideNumber < rideNumber2) {
-    // if root's ridenumber is lesser than given
-    // ridenumber then look in right side
-    searchInRangeRecursive(root->getRight(), rideNumber1, rideNumber2, vec);
+  return iterator(candidate, nil);
+}
+
+/**
+ * @brief Finds the first node with a ride number greater than the given one.
+ *
+ * @param rideNumber The ride number to look for.
+ * @return An iterator to the node found, or end() if there is none.
+ */
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::iterator
+basicRbTree<Key, Payload, Order>::upperBound(Key rideNumber) const {
+  const nodeType *node = root, *candidate = nil;
+
+  while (node != nil) {
+    if (Order::less(rideNumber,
+                    Order::key(*node))) { // node qualifies, look for a smaller
+                                          // one on the left side
+      candidate = node;
+      node = node->getLeft();
+    } else {
+      node = node->getRight();
+    }
   }
+
+  return iterator(candidate, nil);
+}
+
+/**
+ * @brief Returns the iterator past the last node of the tree.
+ *
+ * @return An iterator pointing to the sentinel node.
+ */
+template <typename Key, typename Payload, typename Order>
+typename basicRbTree<Key, Payload, Order>::iterator
+basicRbTree<Key, Payload, Order>::end() const {
+  return iterator(nil, nil);
 }
 
 /**
-* @brief Search for nodes within a given range.
-* Given two ride numbers, this function searches the red-black tree for the
-* nodes with the ride numbers within the
-* given range by calling searchInRangeRecursive function. It returns a vector
-containing the nodes found within the
-* range.
-*
-* @param rideNumber1 The lower bound of the range of ride numbers to be
-* searched.
-* @param rideNumber2 The upper bound of the range of ride numbers to be
-* searched.
-* @return A vector containing the nodes with the ride numbers within the given
-* range.
-*/
-std::vector<rbNode> rbTree::searchInRange(int rideNumber1, int rideNumber2) {
-  std::vector<rbNode> res;
-  searchInRangeRecursive(root, rideNumber1, rideNumber2, res);
-  return res;
-}
\ No newline at end of file
+ * @brief Returns the node pool of the tree.
+ *
+ * @return A reference to the node pool, to inspect its counters.
+ */
+template <typename Key, typename Payload, typename Order>
+const basicRbNodePool<Payload> &
+basicRbTree<Key, Payload, Order>::getPool() const {
+  return pool;
+}
+
+// Instantiations available to the rest of the program.
+template class basicRbTree<rideNumberType, rideInfo, byRideNumber<rideInfo>>;
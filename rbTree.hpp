@@ -2,59 +2,207 @@
 #define RBTREE_H
 
 #include "rbNode.hpp"
+#include "rbNodePool.hpp"
+#include "rideTypes.hpp"
+#include <cstdint>
 #include <vector>
 
-class rbTree {
+// Red black tree of nodes holding a Payload, ordered by the Key that the
+// Order policy extracts from it (see rideTypes.hpp). The member functions are
+// instantiated in rbTree.cpp for the trees named at the end of this header.
+template <typename Key, typename Payload, typename Order> class basicRbTree {
+public:
+  using nodeType = basicRbNode<Payload>;
+
 private:
-  rbNode *root, *nil;
+  // Bound on the height of a red black tree with at most 2^31 nodes, which is
+  // 2 * log2(n + 1).
+  static constexpr int maxHeight = 64;
+
+  nodeType *root, *nil;
+
+  // Sentinel standing in for every missing child and the parent of the root.
+  // Rebalancing writes to it, so every tree has its own and trees can be used
+  // from different threads.
+  nodeType sentinel;
+
+  // Allocator for the nodes of this tree.
+  basicRbNodePool<Payload> pool;
 
   // Checks if the node is a left child or right child of its parent.
-  bool isLeftChild(rbNode *node);
-  bool isRightChild(rbNode *node);
+  bool isLeftChild(nodeType *node);
+  bool isRightChild(nodeType *node);
 
   // Updates parent-child link by replacing old child with new child.
-  void UpdateParentChildLink(rbNode *parent, rbNode *oldChild,
-                             rbNode *newChild);
+  void UpdateParentChildLink(nodeType *parent, nodeType *oldChild,
+                             nodeType *newChild);
+
+  // Recomputes the subtree size of a node from its children.
+  void updateSize(nodeType *node);
 
   // Performs a left rotation and right rotation on the given node.
-  void rotateLeft(rbNode *node);
-  void rotateRight(rbNode *node);
+  void rotateLeft(nodeType *node);
+  void rotateRight(nodeType *node);
 
   // Returns the node with the minimum ride number in the subtree rooted at
   // node.
-  rbNode *getMinimumNode(rbNode *node);
+  nodeType *getMinimumNode(nodeType *node);
 
   // Rebalances the tree after inserting a new node.
-  void insertionRebalance(rbNode *node);
+  void insertionRebalance(nodeType *node);
 
   // Rebalances the tree after deleting a node.
-  void DeletionRebalance(rbNode *node);
+  void DeletionRebalance(nodeType *node);
+
+  // Appends the nodes of the tree to the vector in ride number order.
+  void collectNodes(std::vector<nodeType *> &nodes);
 
-  // Searches for a node with the given ride number recursively starting from
-  // the given root node.
-  rbNode *searchRecursive(rbNode *root, int rideNumber);
+  // Links the sorted nodes between the given indexes into a balanced subtree
+  // below parent and returns its root. Nodes at redDepth are colored red.
+  nodeType *buildBalanced(std::vector<nodeType *> &nodes, int first,
+                          int last, int depth, int redDepth,
+                          nodeType *parent);
 
-  // Searches for all nodes with ride numbers in the given range recursively
-  // starting from the given root node.
-  void searchInRangeRecursive(rbNode *root, int rideNumber1, int rideNumber2,
-                              std::vector<rbNode> &vec);
+  // Replaces the tree by a balanced tree of the given sorted nodes.
+  void rebuild(std::vector<nodeType *> &nodes);
 
 public:
+  // Iterator visiting the nodes of the tree in ride number order. It hands
+  // out const references to the nodes, so iterating copies nothing.
+  class iterator {
+  private:
+    // Current node and the sentinel ending the walk.
+    const nodeType *node, *nil;
+
+  public:
+    iterator(const nodeType *node, const nodeType *nil);
+
+    const nodeType &operator*() const;
+    const nodeType *operator->() const;
+
+    // Moves to the in-order successor of the current node.
+    iterator &operator++();
+
+    bool operator==(const iterator &other) const;
+    bool operator!=(const iterator &other) const;
+  };
+
   // Constructor and destructor for a new Red-Black Tree.
-  rbTree();
-  ~rbTree();
+  basicRbTree();
+  ~basicRbTree();
+
+  // The nodes point at the sentinel inside the tree, so a tree cannot be
+  // copied or moved.
+  basicRbTree(const basicRbTree &) = delete;
+  basicRbTree &operator=(const basicRbTree &) = delete;
+
+  // Creates a node for the given ride. The node belongs to this tree and is
+  // recycled when it is deleted.
+  nodeType *createNode(const Payload &ride);
 
   // Inserts the given node into the tree.
-  void insert(rbNode *node);
+  void insert(nodeType *node);
+
+  // Inserts all given nodes at once by rebuilding the tree in linear time.
+  // Throws std::runtime_error and leaves the tree unchanged if a ride number
+  // is duplicated.
+  void bulkInsert(std::vector<nodeType *> &nodes);
+
+  // Returns a node that was never inserted, or failed to insert, to the pool.
+  void destroyNode(nodeType *node);
+
+  // Deletes the given node from the tree and recycles it.
+  void deleteNode(nodeType *node);
 
-  // Deletes the given node from the tree.
-  void deleteNode(rbNode *node);
+  // Deletes all given nodes from the tree and recycles them.
+  void deleteNodes(std::vector<nodeType *> &nodes);
 
   // Searches for a node with the given ride number in the tree.
-  rbNode *search(int rideNumber);
+  nodeType *search(Key rideNumber);
+
+  // Returns the number of nodes in the tree.
+  int getSize() const;
+
+  // Returns the number of nodes with a ride number below the given one, or
+  // not above it if inclusive is set.
+  int countBelow(Key rideNumber, bool inclusive) const;
+
+  // Returns the number of nodes with ride numbers in the given range.
+  int countInRange(Key rideNumber1, Key rideNumber2) const;
 
-  // Searches for all nodes with ride numbers in the given range.
-  std::vector<rbNode> searchInRange(int rideNumber1, int rideNumber2);
+  // Returns the node with the k-th smallest ride number, counting from 1, or
+  // nullptr if the tree has fewer than k nodes.
+  nodeType *select(int k) const;
+
+  // Returns the number of nodes with a ride number not above the given one,
+  // which is the position of the ride in ride number order if it exists.
+  int rank(Key rideNumber) const;
+
+  // Returns an iterator to the first node with a ride number not less than
+  // (lowerBound) or greater than (upperBound) the given one.
+  iterator lowerBound(Key rideNumber) const;
+  iterator upperBound(Key rideNumber) const;
+
+  // Returns the iterator past the last node of the tree.
+  iterator end() const;
+
+  // Calls visit with a const reference to every node whose ride number lies
+  // in the given range, in ride number order.
+  template <typename Visitor>
+  void forEachInRange(Key rideNumber1, Key rideNumber2, Visitor visit) const;
+
+  // Returns the allocator of this tree, to inspect its counters.
+  const basicRbNodePool<Payload> &getPool() const;
 };
 
+/**
+ * @brief Visits all nodes within a given range.
+ * This is an in-order walk with an explicit stack of the ancestors still to
+ * be visited. Unlike following the parent pointers, every node is loaded only
+ * once, which matters because neighbouring rides are scattered in memory. The
+ * walk takes O(log n + k) steps for k nodes in the range and allocates
+ * nothing.
+ *
+ * @param rideNumber1 The lower bound of the range of ride numbers.
+ * @param rideNumber2 The upper bound of the range of ride numbers.
+ * @param visit Function called with a const reference to every node found.
+ */
+template <typename Key, typename Payload, typename Order>
+template <typename Visitor>
+void basicRbTree<Key, Payload, Order>::forEachInRange(Key rideNumber1,
+                                                      Key rideNumber2,
+                                                      Visitor visit) const {
+  const nodeType *pending[maxHeight];
+  int depth = 0;
+
+  // Descend to the first node of the range, keeping the nodes that are in or
+  // after the range and still have to be visited.
+  const nodeType *node = root;
+  while (node != nil) {
+    if (!Order::less(Order::key(*node), rideNumber1)) {
+      pending[depth++] = node;
+      node = node->getLeft();
+    } else {
+      node = node->getRight();
+    }
+  }
+
+  while (depth > 0) {
+    node = pending[--depth];
+    if (Order::less(rideNumber2, Order::key(*node))) {
+      return;
+    }
+
+    visit(*node);
+
+    // The successors in the right subtree come before the pending ancestors.
+    for (node = node->getRight(); node != nil; node = node->getLeft()) {
+      pending[depth++] = node;
+    }
+  }
+}
+
+// The tree of GatorTaxi's rides.
+using rbTree = basicRbTree<rideNumberType, rideInfo, byRideNumber<rideInfo>>;
+
 #endif // RBTREE_H
\ No newline at end of file
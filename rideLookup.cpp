@@ -0,0 +1,211 @@
+#include "rideLookup.hpp"
+#include <algorithm>
+
+/**
+ * @brief Constructor for rideLookup class, starting with a small hash table
+ * and no direct-address table.
+ */
+rideLookup::rideLookup()
+    : table(16, slot{0, nullptr}), shift(64 - 4), hashed(0), count(0) {}
+
+/**
+ * @brief Returns the slot a ride number hashes to, by Fibonacci hashing: the
+ * ride number is multiplied by 2^64 divided by the golden ratio, and the top
+ * bits of the product pick the slot, so consecutive ride numbers spread over
+ * the whole table.
+ *
+ * @param rideNumber The ride number.
+ * @return The index of the slot.
+ */
+std::size_t rideLookup::home(rideNumberType rideNumber) const {
+  return (static_cast<std::uint64_t>(rideNumber) * 0x9E3779B97F4A7C15ull) >>
+         shift;
+}
+
+/**
+ * @brief Grows the direct-address table to cover a ride number.
+ *
+ * @details The table doubles until it covers the ride number, as long as it
+ * stays within max(2^16, 8 * rides) entries, so sparse or negative ride
+ * numbers are left to the hash table. Rides in the hash table that the grown
+ * table covers move over, which keeps every ride in exactly one of the two
+ * tables. Each doubling at least doubles the size, so the moves take
+ * amortized constant time per ride.
+ *
+ * @param rideNumber The ride number to cover.
+ * @return True if the direct-address table covers the ride number.
+ */
+bool rideLookup::coverDense(rideNumberType rideNumber) {
+  if (rideNumber < 0) {
+    return false;
+  }
+  std::size_t number = rideNumber;
+  if (number < dense.size()) {
+    return true;
+  }
+
+  std::size_t limit =
+      std::max(minimumDenseLimit, 8 * static_cast<std::size_t>(count + 1));
+  std::size_t size = std::max<std::size_t>(dense.size(), 64);
+  while (size <= number) {
+    size *= 2;
+  }
+  if (size > limit) {
+    return false;
+  }
+  dense.resize(size, nullptr);
+
+  if (hashed > 0) {
+    std::vector<slot> old(table.size(), slot{0, nullptr});
+    old.swap(table);
+    hashed = 0;
+    for (const slot &entry : old) {
+      if (entry.ride == nullptr) {
+        continue;
+      }
+      if (entry.rideNumber >= 0 &&
+          static_cast<std::size_t>(entry.rideNumber) < size) {
+        dense[entry.rideNumber] = entry.ride;
+      } else {
+        insertHashed(entry.ride);
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Rehashes the entries of the hash table into a table of a new size.
+ *
+ * @param slots The new number of slots, a power of two above the number of
+ * entries.
+ */
+void rideLookup::resizeTable(std::size_t slots) {
+  std::vector<slot> old(slots, slot{0, nullptr});
+  old.swap(table);
+
+  shift = 64;
+  for (std::size_t size = slots; size > 1; size /= 2) {
+    shift--;
+  }
+
+  hashed = 0;
+  for (const slot &entry : old) {
+    if (entry.ride != nullptr) {
+      insertHashed(entry.ride);
+    }
+  }
+}
+
+/**
+ * @brief Adds a ride to the first free slot at or after its home slot.
+ *
+ * @param ride The red black node of the ride.
+ */
+void rideLookup::insertHashed(rbNode *ride) {
+  std::size_t mask = table.size() - 1;
+  std::size_t index = home(ride->rideNumber);
+  while (table[index].ride != nullptr) {
+    index = (index + 1) & mask;
+  }
+  table[index] = {ride->rideNumber, ride};
+  hashed++;
+}
+
+/**
+ * @brief Adds a ride to the lookup.
+ *
+ * @details The hash table is kept at most half full, which bounds the
+ * expected length of a probe sequence by a small constant.
+ *
+ * @param ride The red black node of the ride, whose ride number must not be
+ * in the lookup yet.
+ */
+void rideLookup::insert(rbNode *ride) {
+  count++;
+  if (coverDense(ride->rideNumber)) {
+    dense[ride->rideNumber] = ride;
+    return;
+  }
+
+  if (2 * (hashed + 1) > static_cast<int>(table.size())) {
+    resizeTable(2 * table.size());
+  }
+  insertHashed(ride);
+}
+
+/**
+ * @brief Removes the ride with a ride number from the lookup.
+ *
+ * @details A removed hash table entry leaves a gap that later entries of the
+ * same probe sequence must not skip over. Every following entry up to the
+ * next free slot whose home slot does not lie between the gap and itself
+ * moves back into the gap, which opens a new gap where it was.
+ *
+ * @param rideNumber The ride number.
+ */
+void rideLookup::erase(rideNumberType rideNumber) {
+  if (rideNumber >= 0 &&
+      static_cast<std::uint64_t>(rideNumber) < dense.size()) {
+    if (dense[rideNumber] != nullptr) {
+      dense[rideNumber] = nullptr;
+      count--;
+    }
+    return;
+  }
+
+  std::size_t mask = table.size() - 1;
+  std::size_t gap = home(rideNumber);
+  while (table[gap].ride != nullptr && table[gap].rideNumber != rideNumber) {
+    gap = (gap + 1) & mask;
+  }
+  if (table[gap].ride == nullptr) {
+    return;
+  }
+
+  for (std::size_t next = (gap + 1) & mask; table[next].ride != nullptr;
+       next = (next + 1) & mask) {
+    // Distances travelled from the home slot to the gap and to next
+    std::size_t start = home(table[next].rideNumber);
+    if (((gap - start) & mask) < ((next - start) & mask)) {
+      table[gap] = table[next];
+      gap = next;
+    }
+  }
+
+  table[gap].ride = nullptr;
+  hashed--;
+  count--;
+}
+
+/**
+ * @brief Finds the ride with a ride number.
+ *
+ * @param rideNumber The ride number.
+ * @return The red black node of the ride, or nullptr if it is not in the
+ * lookup.
+ */
+rbNode *rideLookup::find(rideNumberType rideNumber) const {
+  if (rideNumber >= 0 &&
+      static_cast<std::uint64_t>(rideNumber) < dense.size()) {
+    return dense[rideNumber];
+  }
+
+  std::size_t mask = table.size() - 1;
+  for (std::size_t index = home(rideNumber); table[index].ride != nullptr;
+       index = (index + 1) & mask) {
+    if (table[index].rideNumber == rideNumber) {
+      return table[index].ride;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Returns the number of rides in the lookup.
+ *
+ * @return The number of rides.
+ */
+int rideLookup::getSize() const {
+  return count;
+}
@@ -0,0 +1,69 @@
+#ifndef RIDELOOKUP_H
+#define RIDELOOKUP_H
+
+#include "rbNode.hpp"
+#include <cstdint>
+#include <vector>
+
+// Maps ride numbers straight to the red black nodes of the rides, so that
+// Print, CancelRide and UpdateTrip find a ride in constant expected time
+// instead of descending the tree. The tree stays in charge of everything
+// ordered; the lookup only mirrors which rides exist and must be told about
+// every insert and delete.
+//
+// Ride numbers that are small compared to the number of rides go into a
+// direct-address table indexed by the ride number, which needs no hashing
+// or probing at all. Any other ride number goes into an open-addressing hash
+// table with linear probing, which deletes by shifting entries back rather
+// than leaving tombstones, so probe sequences stay short under churn.
+class rideLookup {
+private:
+  // An entry of the hash table, empty if ride is nullptr.
+  struct slot {
+    rideNumberType rideNumber;
+    rbNode *ride;
+  };
+
+  // The direct-address table never grows beyond this many entries, or eight
+  // entries per ride if that is more.
+  static constexpr std::size_t minimumDenseLimit = 1 << 16;
+
+  std::vector<rbNode *> dense; // dense[n] is the ride numbered n, or nullptr.
+  std::vector<slot> table;     // Hash table, its size is a power of two.
+  int shift;                   // 64 minus the log2 of the table size.
+  int hashed;                  // Number of entries in the hash table.
+  int count;                   // Number of rides in the lookup.
+
+  // Returns the slot a ride number hashes to.
+  std::size_t home(rideNumberType rideNumber) const;
+
+  // Grows the direct-address table to cover the given ride number if that
+  // keeps it within its limit, moving the rides it now covers out of the
+  // hash table. Returns whether the ride number is covered.
+  bool coverDense(rideNumberType rideNumber);
+
+  // Rehashes the entries of the hash table into the given number of slots,
+  // a power of two.
+  void resizeTable(std::size_t slots);
+
+  // Adds a ride to the hash table, which has a free slot.
+  void insertHashed(rbNode *ride);
+
+public:
+  // Constructor for an empty lookup.
+  rideLookup();
+
+  // Adds a ride, whose ride number must not be in the lookup yet.
+  void insert(rbNode *ride);
+
+  // Removes the ride with the given ride number if it is in the lookup.
+  void erase(rideNumberType rideNumber);
+
+  // Returns the ride with the given ride number, or nullptr if there is none.
+  rbNode *find(rideNumberType rideNumber) const;
+
+  // Returns the number of rides in the lookup.
+  int getSize() const;
+};
+
+#endif // RIDELOOKUP_H
@@ -0,0 +1,221 @@
+#include "rideStore.hpp"
+#include "minHeap.hpp"
+#include "packedHeap.hpp"
+#include "pairingHeap.hpp"
+
+/**
+ * @brief Constructor for the ride store, which starts out empty.
+ */
+template <typename Heap> rideStore<Heap>::rideStore() {}
+
+/**
+ * @brief Destructor for the ride store.
+ */
+template <typename Heap> rideStore<Heap>::~rideStore() {}
+
+/**
+ * @brief Returns the number of rides.
+ *
+ * @return The number of rides in the store.
+ */
+template <typename Heap> int rideStore<Heap>::getSize() const {
+  return tree.getSize();
+}
+
+/**
+ * @brief Inserts a ride into both the red black tree and the heap.
+ *
+ * @param rideNumber The ride number.
+ * @param rideCost The cost of the ride.
+ * @param tripDuration The duration of the trip.
+ * @return false if the ride number is already in use, true otherwise.
+ */
+template <typename Heap>
+bool rideStore<Heap>::insert(rideNumberType rideNumber, int rideCost,
+                             int tripDuration) {
+  rbNode *ride = tree.createNode({rideNumber, rideCost, tripDuration});
+  try {
+    tree.insert(ride);
+  } catch (const std::exception &) {
+    tree.destroyNode(ride);
+    return false;
+  }
+  heap.insert(ride);
+  return true;
+}
+
+/**
+ * @brief Copies the ride with the lowest cost and trip duration.
+ *
+ * @param ride Receives the ride.
+ * @return false if there are no rides, true otherwise.
+ */
+template <typename Heap> bool rideStore<Heap>::peekNextRide(rideInfo &ride) {
+  rbNode *next = heap.peekMin();
+  if (next == nullptr) {
+    return false;
+  }
+  ride = {next->rideNumber, next->rideCost, next->tripDuration};
+  return true;
+}
+
+/**
+ * @brief Removes the ride with the lowest cost and trip duration.
+ *
+ * @param ride Receives the removed ride.
+ * @return false if there are no rides, true otherwise.
+ */
+template <typename Heap> bool rideStore<Heap>::getNextRide(rideInfo &ride) {
+  if (heap.getSize() == 0) {
+    return false;
+  }
+
+  rbNode *next = heap.removeMin();
+  ride = {next->rideNumber, next->rideCost, next->tripDuration};
+  tree.deleteNode(next);
+  return true;
+}
+
+/**
+ * @brief Removes up to count rides in priority order.
+ *
+ * @details The rides are taken from the heap in one loop and then deleted
+ * from the tree as a batch, which rebuilds the tree when the batch is large
+ * compared to it.
+ *
+ * @param count The maximum number of rides to remove.
+ * @param rides The vector the removed rides are appended to.
+ * @return The number of rides removed.
+ */
+template <typename Heap>
+int rideStore<Heap>::getNextRides(int count, std::vector<rideInfo> &rides) {
+  std::vector<rbNode *> removed;
+  int taken = heap.removeMins(count, removed);
+
+  for (rbNode *next : removed) {
+    rides.push_back({next->rideNumber, next->rideCost, next->tripDuration});
+  }
+  tree.deleteNodes(removed);
+  return taken;
+}
+
+/**
+ * @brief Looks up a ride by its ride number.
+ *
+ * @param rideNumber The ride number.
+ * @param ride Receives the ride if it exists.
+ * @return false if the ride does not exist, true otherwise.
+ */
+template <typename Heap>
+bool rideStore<Heap>::find(rideNumberType rideNumber, rideInfo &ride) {
+  rbNode *node = tree.search(rideNumber);
+  if (node == nullptr) {
+    return false;
+  }
+  ride = {node->rideNumber, node->rideCost, node->tripDuration};
+  return true;
+}
+
+/**
+ * @brief Collects the rides in a range of ride numbers.
+ *
+ * @param rideNumber1 The start of the range (inclusive).
+ * @param rideNumber2 The end of the range (inclusive).
+ * @param rides The vector the rides are appended to, in ride number order.
+ */
+template <typename Heap>
+void rideStore<Heap>::findInRange(rideNumberType rideNumber1,
+                                  rideNumberType rideNumber2,
+                                  std::vector<rideInfo> &rides) const {
+  tree.forEachInRange(rideNumber1, rideNumber2, [&](const rbNode &ride) {
+    rides.push_back({ride.rideNumber, ride.rideCost, ride.tripDuration});
+  });
+}
+
+/**
+ * @brief Changes the trip duration of a ride. The cost grows by 10 if the
+ * trip gets longer, and the ride is declined and removed if the new duration
+ * is more than twice the current one.
+ *
+ * @param rideNumber The ride number.
+ * @param newTripDuration The new trip duration.
+ */
+template <typename Heap>
+void rideStore<Heap>::updateTrip(rideNumberType rideNumber,
+                                 int newTripDuration) {
+  rbNode *ride = tree.search(rideNumber);
+  if (ride == nullptr) {
+    return;
+  }
+
+  if (newTripDuration <= 2 * ride->tripDuration) {
+    ride->rideCost += newTripDuration <= ride->tripDuration ? 0 : 10;
+    ride->tripDuration = newTripDuration;
+    heap.update(ride);
+  } else {
+    int idx = ride->getHeapHandle();
+    tree.deleteNode(ride);
+    heap.remove(idx);
+  }
+}
+
+/**
+ * @brief Removes a ride from both the red black tree and the heap.
+ *
+ * @param rideNumber The ride number.
+ */
+template <typename Heap>
+void rideStore<Heap>::cancelRide(rideNumberType rideNumber) {
+  rbNode *ride = tree.search(rideNumber);
+  if (ride != nullptr) {
+    int idx = ride->getHeapHandle();
+    tree.deleteNode(ride);
+    heap.remove(idx);
+  }
+}
+
+/**
+ * @brief Counts the rides in a range of ride numbers.
+ *
+ * @param rideNumber1 The start of the range (inclusive).
+ * @param rideNumber2 The end of the range (inclusive).
+ * @return The number of rides in the range.
+ */
+template <typename Heap>
+int rideStore<Heap>::countInRange(rideNumberType rideNumber1,
+                                  rideNumberType rideNumber2) const {
+  return tree.countInRange(rideNumber1, rideNumber2);
+}
+
+/**
+ * @brief Finds the ride with the k-th smallest ride number.
+ *
+ * @param k The 1-based position of the ride in ride number order.
+ * @param ride Receives the ride if it exists.
+ * @return false if k is out of range, true otherwise.
+ */
+template <typename Heap>
+bool rideStore<Heap>::select(int k, rideInfo &ride) const {
+  rbNode *node = tree.select(k);
+  if (node == nullptr) {
+    return false;
+  }
+  ride = {node->rideNumber, node->rideCost, node->tripDuration};
+  return true;
+}
+
+/**
+ * @brief Counts the rides with a ride number of at most the given one.
+ *
+ * @param rideNumber The largest ride number counted.
+ * @return The number of rides.
+ */
+template <typename Heap>
+int rideStore<Heap>::rank(rideNumberType rideNumber) const {
+  return tree.rank(rideNumber);
+}
+
+// Heaps available to the rest of the program.
+template class rideStore<minHeap<4>>;
+template class rideStore<packedHeap<8>>;
+template class rideStore<pairingHeap>;
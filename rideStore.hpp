@@ -0,0 +1,60 @@
+#ifndef RIDESTORE_H
+#define RIDESTORE_H
+
+#include "rbTree.hpp"
+#include <vector>
+
+// The rides of one dispatcher: a red black tree ordered by ride number and a
+// heap ordered by cost and trip duration, linked to each other. All results
+// are returned as copies. A store is not thread-safe; it is used by one thread
+// or behind a lock.
+template <typename Heap> class rideStore {
+private:
+  rbTree tree;
+  Heap heap;
+
+public:
+  // constructor and destructor
+  rideStore();
+  ~rideStore();
+
+  // Returns the number of rides.
+  int getSize() const;
+
+  // Inserts a ride, returning false if the ride number is already in use.
+  bool insert(rideNumberType rideNumber, int rideCost, int tripDuration);
+
+  // Copies the ride with the lowest cost and duration without removing it,
+  // returning false if there are no rides.
+  bool peekNextRide(rideInfo &ride);
+
+  // Removes the ride with the lowest cost and duration, returning false if
+  // there are no rides.
+  bool getNextRide(rideInfo &ride);
+
+  // Removes up to count rides in priority order and appends them to rides,
+  // returning how many were removed.
+  int getNextRides(int count, std::vector<rideInfo> &rides);
+
+  // Looks up a ride, returning false if it does not exist.
+  bool find(rideNumberType rideNumber, rideInfo &ride);
+
+  // Appends the rides with ride numbers in [rideNumber1, rideNumber2] to
+  // rides, in ride number order.
+  void findInRange(rideNumberType rideNumber1, rideNumberType rideNumber2,
+                   std::vector<rideInfo> &rides) const;
+
+  // Changes the trip duration of a ride with the rules of UpdateTrip.
+  void updateTrip(rideNumberType rideNumber, int newTripDuration);
+
+  // Removes a ride if it exists.
+  void cancelRide(rideNumberType rideNumber);
+
+  // Order statistics, with the meaning of the rbTree ones.
+  int countInRange(rideNumberType rideNumber1,
+                   rideNumberType rideNumber2) const;
+  bool select(int k, rideInfo &ride) const;
+  int rank(rideNumberType rideNumber) const;
+};
+
+#endif // RIDESTORE_H
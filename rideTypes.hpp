@@ -0,0 +1,64 @@
+#ifndef RIDETYPES_H
+#define RIDETYPES_H
+
+#include <cstdint>
+
+// The rides stored by the containers and the orders they are kept in. The
+// tree and heap templates take a payload, which their nodes derive from, and
+// order policies with static member functions, so every comparison is
+// resolved at compile time and inlined. A policy provides:
+//
+//   using keyType = ...;                        // the key it orders by
+//   static keyType key(const Payload &ride);    // extracts the key of a ride
+//   static bool less(keyType a, keyType b);     // strict weak order of keys
+//
+// GatorTaxi itself is the instantiation with rideInfo, byRideNumber and
+// byCostAndDuration.
+
+// Ride numbers are 64-bit, since they outgrow the int range, while costs and
+// durations stay ints.
+using rideNumberType = std::int64_t;
+
+// A ride as GatorTaxi stores it, also used to copy rides out of a container.
+struct rideInfo {
+  rideNumberType rideNumber;
+  int rideCost, tripDuration;
+};
+
+// Orders rides by their ride number.
+template <typename Ride> struct byRideNumber {
+  using keyType = decltype(Ride::rideNumber);
+
+  static keyType key(const Ride &ride) { return ride.rideNumber; }
+  static bool less(keyType a, keyType b) { return a < b; }
+};
+
+// Orders rides by their cost, and rides of the same cost by their trip
+// duration, which is the order GatorTaxi dispatches them in.
+template <typename Ride> struct byCostAndDuration {
+  struct keyType {
+    int rideCost, tripDuration;
+  };
+
+  static keyType key(const Ride &ride) {
+    return {ride.rideCost, ride.tripDuration};
+  }
+  static bool less(keyType a, keyType b) {
+    if (a.rideCost == b.rideCost) {
+      return a.tripDuration < b.tripDuration;
+    }
+    return a.rideCost < b.rideCost;
+  }
+};
+
+// Packs the cost and trip duration of a ride into one 64-bit key, the cost in
+// the high half and the duration in the low half. Both halves are biased by
+// 2^31, so the unsigned order of the keys is the order of byCostAndDuration.
+// packedHeap and pairingHeap keep their rides in this order.
+inline std::uint64_t packKey(int rideCost, int tripDuration) {
+  std::uint32_t high = static_cast<std::uint32_t>(rideCost) ^ 0x80000000u;
+  std::uint32_t low = static_cast<std::uint32_t>(tripDuration) ^ 0x80000000u;
+  return (static_cast<std::uint64_t>(high) << 32) | low;
+}
+
+#endif // RIDETYPES_H
@@ -0,0 +1,339 @@
+#include "shardedDispatcher.hpp"
+#include "minHeap.hpp"
+#include "packedHeap.hpp"
+#include "pairingHeap.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Constructor for the sharded dispatcher.
+ *
+ * @param shardCount The number of shards, raised to one if smaller.
+ */
+template <typename Heap>
+shardedDispatcher<Heap>::shardedDispatcher(int shardCount)
+    : shardCount(std::max(shardCount, 1)),
+      shards(new shard[std::max(shardCount, 1)]) {}
+
+/**
+ * @brief Destructor for the sharded dispatcher.
+ */
+template <typename Heap> shardedDispatcher<Heap>::~shardedDispatcher() {}
+
+/**
+ * @brief Returns the number of shards.
+ *
+ * @return The number of shards.
+ */
+template <typename Heap> int shardedDispatcher<Heap>::getShardCount() const {
+  return shardCount;
+}
+
+/**
+ * @brief Returns the shard that owns a ride number.
+ *
+ * @details The ride number is scrambled with a multiplicative hash, so that
+ * consecutive ride numbers land on different shards, and the top 32 bits of
+ * the hash are then scaled to the number of shards without a division.
+ *
+ * @param rideNumber The ride number.
+ * @return The shard owning the ride number.
+ */
+template <typename Heap>
+typename shardedDispatcher<Heap>::shard &
+shardedDispatcher<Heap>::getShard(rideNumberType rideNumber) {
+  std::uint64_t hash =
+      static_cast<std::uint64_t>(rideNumber) * 0x9E3779B97F4A7C15ull;
+  return shards[((hash >> 32) * shardCount) >> 32];
+}
+
+/**
+ * @brief Locks every shard in index order.
+ */
+template <typename Heap> void shardedDispatcher<Heap>::lockAll() {
+  for (int i = 0; i < shardCount; i++) {
+    shards[i].lock.lock();
+  }
+}
+
+/**
+ * @brief Unlocks every shard.
+ */
+template <typename Heap> void shardedDispatcher<Heap>::unlockAll() {
+  for (int i = shardCount - 1; i >= 0; i--) {
+    shards[i].lock.unlock();
+  }
+}
+
+/**
+ * @brief Finds the shard holding the minimum ride of all shards by comparing
+ * the minimum of every shard heap. Every shard must be locked.
+ *
+ * @return The shard with the minimum ride, or nullptr if there are no rides.
+ */
+template <typename Heap>
+typename shardedDispatcher<Heap>::shard *
+shardedDispatcher<Heap>::getMinShard() {
+  shard *minShard = nullptr;
+  rideInfo minRide, ride;
+
+  for (int i = 0; i < shardCount; i++) {
+    if (shards[i].store.peekNextRide(ride) &&
+        (minShard == nullptr || ride.rideCost < minRide.rideCost ||
+         (ride.rideCost == minRide.rideCost &&
+          ride.tripDuration < minRide.tripDuration))) {
+      minShard = &shards[i];
+      minRide = ride;
+    }
+  }
+  return minShard;
+}
+
+/**
+ * @brief Counts the rides with a ride number of at most the given one over
+ * all shards. Every shard must be locked.
+ *
+ * @param rideNumber The largest ride number counted.
+ * @return The number of rides.
+ */
+template <typename Heap>
+int shardedDispatcher<Heap>::countAtMost(rideNumberType rideNumber) {
+  int count = 0;
+  for (int i = 0; i < shardCount; i++) {
+    count += shards[i].store.rank(rideNumber);
+  }
+  return count;
+}
+
+/**
+ * @brief Inserts a ride into the shard owning its ride number.
+ *
+ * @param rideNumber The ride number.
+ * @param rideCost The cost of the ride.
+ * @param tripDuration The duration of the trip.
+ * @return false if the ride number is already in use, true otherwise.
+ */
+template <typename Heap>
+bool shardedDispatcher<Heap>::insert(rideNumberType rideNumber, int rideCost,
+                                     int tripDuration) {
+  shard &owner = getShard(rideNumber);
+  std::lock_guard<std::mutex> guard(owner.lock);
+  return owner.store.insert(rideNumber, rideCost, tripDuration);
+}
+
+/**
+ * @brief Removes the ride with the lowest cost and trip duration over all
+ * shards.
+ *
+ * @param ride Receives the removed ride.
+ * @return false if there are no rides, true otherwise.
+ */
+template <typename Heap>
+bool shardedDispatcher<Heap>::getNextRide(rideInfo &ride) {
+  lockAll();
+
+  shard *minShard = getMinShard();
+  if (minShard != nullptr) {
+    minShard->store.getNextRide(ride);
+  }
+
+  unlockAll();
+  return minShard != nullptr;
+}
+
+/**
+ * @brief Removes up to count rides in priority order over all shards.
+ *
+ * @details Every shard is locked once for the whole batch, and each ride is
+ * taken from the shard with the smallest minimum at that point.
+ *
+ * @param count The maximum number of rides to remove.
+ * @param rides The vector the removed rides are appended to.
+ * @return The number of rides removed.
+ */
+template <typename Heap>
+int shardedDispatcher<Heap>::getNextRides(int count,
+                                          std::vector<rideInfo> &rides) {
+  int taken = 0;
+  rideInfo ride;
+
+  lockAll();
+
+  for (; taken < count; taken++) {
+    shard *minShard = getMinShard();
+    if (minShard == nullptr) {
+      break;
+    }
+
+    minShard->store.getNextRide(ride);
+    rides.push_back(ride);
+  }
+
+  unlockAll();
+  return taken;
+}
+
+/**
+ * @brief Looks up a ride in the shard owning its ride number.
+ *
+ * @param rideNumber The ride number.
+ * @param ride Receives the ride if it exists.
+ * @return false if the ride does not exist, true otherwise.
+ */
+template <typename Heap>
+bool shardedDispatcher<Heap>::find(rideNumberType rideNumber, rideInfo &ride) {
+  shard &owner = getShard(rideNumber);
+  std::lock_guard<std::mutex> guard(owner.lock);
+  return owner.store.find(rideNumber, ride);
+}
+
+/**
+ * @brief Collects the rides in a range of ride numbers over all shards.
+ *
+ * @details Every shard appends its rides in ride number order, and the
+ * sorted runs are then merged pairwise until a single run is left.
+ *
+ * @param rideNumber1 The start of the range (inclusive).
+ * @param rideNumber2 The end of the range (inclusive).
+ * @param rides The vector the rides are appended to.
+ */
+template <typename Heap>
+void shardedDispatcher<Heap>::findInRange(rideNumberType rideNumber1,
+                                          rideNumberType rideNumber2,
+                                          std::vector<rideInfo> &rides) {
+  std::vector<std::size_t> runs{rides.size()};
+
+  lockAll();
+  for (int i = 0; i < shardCount; i++) {
+    shards[i].store.findInRange(rideNumber1, rideNumber2, rides);
+    runs.push_back(rides.size());
+  }
+  unlockAll();
+
+  auto byRideNumber = [](const rideInfo &a, const rideInfo &b) {
+    return a.rideNumber < b.rideNumber;
+  };
+
+  // runs holds the boundaries of the sorted runs, first and last included.
+  while (runs.size() > 2) {
+    std::vector<std::size_t> merged{runs[0]};
+    for (std::size_t i = 2; i < runs.size(); i += 2) {
+      std::inplace_merge(rides.begin() + runs[i - 2],
+                         rides.begin() + runs[i - 1], rides.begin() + runs[i],
+                         byRideNumber);
+      merged.push_back(runs[i]);
+    }
+    if (runs.size() % 2 == 0) {
+      merged.push_back(runs.back());
+    }
+    runs.swap(merged);
+  }
+}
+
+/**
+ * @brief Changes the trip duration of a ride in the shard owning it.
+ *
+ * @param rideNumber The ride number.
+ * @param newTripDuration The new trip duration.
+ */
+template <typename Heap>
+void shardedDispatcher<Heap>::updateTrip(rideNumberType rideNumber,
+                                         int newTripDuration) {
+  shard &owner = getShard(rideNumber);
+  std::lock_guard<std::mutex> guard(owner.lock);
+  owner.store.updateTrip(rideNumber, newTripDuration);
+}
+
+/**
+ * @brief Removes a ride from the shard owning its ride number.
+ *
+ * @param rideNumber The ride number.
+ */
+template <typename Heap>
+void shardedDispatcher<Heap>::cancelRide(rideNumberType rideNumber) {
+  shard &owner = getShard(rideNumber);
+  std::lock_guard<std::mutex> guard(owner.lock);
+  owner.store.cancelRide(rideNumber);
+}
+
+/**
+ * @brief Counts the rides in a range of ride numbers over all shards.
+ *
+ * @param rideNumber1 The start of the range (inclusive).
+ * @param rideNumber2 The end of the range (inclusive).
+ * @return The number of rides in the range.
+ */
+template <typename Heap>
+int shardedDispatcher<Heap>::countInRange(rideNumberType rideNumber1,
+                                          rideNumberType rideNumber2) {
+  int count = 0;
+
+  lockAll();
+  for (int i = 0; i < shardCount; i++) {
+    count += shards[i].store.countInRange(rideNumber1, rideNumber2);
+  }
+  unlockAll();
+
+  return count;
+}
+
+/**
+ * @brief Finds the ride with the k-th smallest ride number over all shards.
+ *
+ * @details The shards hold unrelated parts of the ride numbers, so the ride
+ * is found by a binary search for the smallest ride number with k rides at
+ * or below it, counting the rides of every shard in O(log n) per step.
+ *
+ * @param k The 1-based position of the ride in ride number order.
+ * @param ride Receives the ride if it exists.
+ * @return false if k is out of range, true otherwise.
+ */
+template <typename Heap>
+bool shardedDispatcher<Heap>::select(int k, rideInfo &ride) {
+  lockAll();
+
+  rideNumberType low = std::numeric_limits<rideNumberType>::min();
+  rideNumberType high = std::numeric_limits<rideNumberType>::max();
+
+  bool found = k >= 1 && k <= countAtMost(high);
+  if (found) {
+    while (low < high) {
+      // The distance between the bounds only fits the unsigned type.
+      std::uint64_t distance =
+          static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+      rideNumberType middle = low + static_cast<rideNumberType>(distance / 2);
+      if (countAtMost(middle) >= k) {
+        high = middle;
+      } else {
+        low = middle + 1;
+      }
+    }
+
+    getShard(low).store.find(low, ride);
+  }
+
+  unlockAll();
+  return found;
+}
+
+/**
+ * @brief Counts the rides with a ride number of at most the given one over
+ * all shards.
+ *
+ * @param rideNumber The largest ride number counted.
+ * @return The number of rides.
+ */
+template <typename Heap>
+int shardedDispatcher<Heap>::rank(rideNumberType rideNumber) {
+  lockAll();
+  int count = countAtMost(rideNumber);
+  unlockAll();
+
+  return count;
+}
+
+// Heaps available to the rest of the program.
+template class shardedDispatcher<minHeap<4>>;
+template class shardedDispatcher<packedHeap<8>>;
+template class shardedDispatcher<pairingHeap>;
@@ -0,0 +1,80 @@
+#ifndef SHARDEDDISPATCHER_H
+#define SHARDEDDISPATCHER_H
+
+#include "rideStore.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// A ride dispatcher split into independent shards, each holding its own ride
+// store behind its own lock. Ride numbers are spread over the shards by a
+// multiplicative hash, so operations on a single ride lock one shard and
+// threads working on different rides rarely wait for each other. Operations
+// spanning all rides lock every shard in index order: GetNextRide takes the
+// smallest of the shard minima, and range queries merge the sorted results of
+// the shards.
+template <typename Heap> class shardedDispatcher {
+private:
+  // One independent partition of the rides.
+  struct shard {
+    std::mutex lock;
+    rideStore<Heap> store;
+  };
+
+  int shardCount;
+  std::unique_ptr<shard[]> shards;
+
+  // Returns the shard that owns a ride number.
+  shard &getShard(rideNumberType rideNumber);
+
+  // Lock and unlock every shard, always in index order to avoid deadlocks.
+  void lockAll();
+  void unlockAll();
+
+  // Returns the shard holding the minimum ride of all shards, or nullptr if
+  // there are no rides. Every shard must be locked.
+  shard *getMinShard();
+
+  // Returns the number of rides with a ride number of at most the given one.
+  // Every shard must be locked.
+  int countAtMost(rideNumberType rideNumber);
+
+public:
+  // Creates a dispatcher with the given number of shards, at least one.
+  explicit shardedDispatcher(int shardCount);
+  ~shardedDispatcher();
+
+  int getShardCount() const;
+
+  // Inserts a ride, returning false if the ride number is already in use.
+  bool insert(rideNumberType rideNumber, int rideCost, int tripDuration);
+
+  // Removes the ride with the lowest cost and duration, returning false if
+  // there are no rides.
+  bool getNextRide(rideInfo &ride);
+
+  // Removes up to count rides in priority order and appends them to rides,
+  // returning how many were removed.
+  int getNextRides(int count, std::vector<rideInfo> &rides);
+
+  // Looks up a ride, returning false if it does not exist.
+  bool find(rideNumberType rideNumber, rideInfo &ride);
+
+  // Appends the rides with ride numbers in [rideNumber1, rideNumber2] to
+  // rides, in ride number order.
+  void findInRange(rideNumberType rideNumber1, rideNumberType rideNumber2,
+                   std::vector<rideInfo> &rides);
+
+  // Changes the trip duration of a ride with the rules of UpdateTrip.
+  void updateTrip(rideNumberType rideNumber, int newTripDuration);
+
+  // Removes a ride if it exists.
+  void cancelRide(rideNumberType rideNumber);
+
+  // Order statistics over all shards, with the meaning of the rbTree ones.
+  int countInRange(rideNumberType rideNumber1, rideNumberType rideNumber2);
+  bool select(int k, rideInfo &ride);
+  int rank(rideNumberType rideNumber);
+};
+
+#endif // SHARDEDDISPATCHER_H
@@ -0,0 +1,210 @@
+#include "snapshot.hpp"
+#include "binaryFormat.hpp"
+#include "mappedFile.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+// Size of the buffer the records are collected in before writing them.
+const std::size_t snapshotBufferSize = 1 << 20;
+
+/**
+ * @brief Writes a whole buffer to a file descriptor.
+ *
+ * @param fd The file descriptor.
+ * @param data The bytes to write.
+ * @param size The number of bytes.
+ * @return True if every byte was written, false on an error.
+ */
+bool writeAll(int fd, const char *data, std::size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+/**
+ * @brief Syncs the directory holding a file, so that a new name of the file
+ * survives a crash.
+ *
+ * @param fileName Path of the file.
+ * @return True if the directory was synced, false on an error.
+ */
+bool syncDirectory(const char *fileName) {
+  std::string directory(fileName);
+  std::size_t slash = directory.rfind('/');
+  if (slash == std::string::npos) {
+    directory = ".";
+  } else {
+    directory.resize(slash == 0 ? 1 : slash);
+  }
+
+  int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = fsync(fd) == 0;
+  return close(fd) == 0 && ok;
+}
+
+} // namespace
+
+/**
+ * @brief Writes a snapshot of the rides in a tree.
+ *
+ * @details The rides are streamed from an in-order walk of the tree through
+ * a fixed buffer. The file is synced before it replaces the previous
+ * snapshot, and its directory after that, so the new snapshot keeps its name
+ * through a crash.
+ *
+ * @param tree The tree holding the rides.
+ * @param fileName Path of the snapshot.
+ * @param logPosition Number of write-ahead log records the rides contain.
+ * @throws std::runtime_error If the snapshot cannot be written.
+ */
+template <typename Tree>
+void writeSnapshot(const Tree &tree, const char *fileName,
+                   std::uint64_t logPosition) {
+  std::string tempName = std::string(fileName) + ".tmp";
+  int fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("could not open file " + tempName);
+  }
+
+  std::unique_ptr<char[]> buffer(new char[snapshotBufferSize]);
+  std::size_t used = snapshotHeaderSize;
+  bool ok = true;
+
+  encodeHeader(snapshotMagic, buffer.get());
+  std::uint64_t count = tree.getSize();
+  std::memcpy(buffer.get() + binaryHeaderSize, &count, sizeof(count));
+  std::memcpy(buffer.get() + binaryHeaderSize + sizeof(count), &logPosition,
+              sizeof(logPosition));
+
+  // Every ride number lies in the full range of the type.
+  const rideNumberType first = std::numeric_limits<rideNumberType>::min();
+  const rideNumberType last = std::numeric_limits<rideNumberType>::max();
+  tree.forEachInRange(first, last, [&](const rbNode &ride) {
+    if (snapshotBufferSize - used < snapshotRecordSize) {
+      ok = ok && writeAll(fd, buffer.get(), used);
+      used = 0;
+    }
+
+    encodeRide(ride.rideNumber, ride.rideCost, ride.tripDuration,
+               buffer.get() + used);
+    used += snapshotRecordSize;
+  });
+
+  ok = ok && writeAll(fd, buffer.get(), used) && fsync(fd) == 0;
+  ok = close(fd) == 0 && ok;
+
+  if (!ok || std::rename(tempName.c_str(), fileName) != 0) {
+    unlink(tempName.c_str());
+    throw std::runtime_error(std::string("could not write snapshot ") +
+                             fileName);
+  }
+
+  if (!syncDirectory(fileName)) {
+    throw std::runtime_error(std::string("could not write snapshot ") +
+                             fileName);
+  }
+}
+
+/**
+ * @brief Writes a snapshot from a forked child process.
+ *
+ * @details The child gets a copy-on-write image of the parent, so it sees the
+ * tree frozen at the time of the fork while the parent goes on changing it.
+ * Only the pages the parent writes to are copied. The child leaves through
+ * _exit, so it neither flushes the output buffers it inherited nor runs the
+ * exit handlers of the parent.
+ *
+ * @param tree The tree holding the rides.
+ * @param fileName Path of the snapshot.
+ * @param logPosition Number of write-ahead log records the rides contain.
+ * @return The process id of the child.
+ * @throws std::runtime_error If the child cannot be created.
+ */
+template <typename Tree>
+pid_t startSnapshot(const Tree &tree, const char *fileName,
+                    std::uint64_t logPosition) {
+  pid_t child = fork();
+  if (child < 0) {
+    throw std::runtime_error("could not start a snapshot process");
+  }
+
+  if (child == 0) {
+    int status = 0;
+    try {
+      writeSnapshot(tree, fileName, logPosition);
+    } catch (const std::exception &) {
+      status = 1;
+    }
+    _exit(status);
+  }
+
+  return child;
+}
+
+template void writeSnapshot<rbTree>(const rbTree &, const char *,
+                                    std::uint64_t);
+template void writeSnapshot<bPlusTree>(const bPlusTree &, const char *,
+                                       std::uint64_t);
+template pid_t startSnapshot<rbTree>(const rbTree &, const char *,
+                                     std::uint64_t);
+template pid_t startSnapshot<bPlusTree>(const bPlusTree &, const char *,
+                                        std::uint64_t);
+
+/**
+ * @brief Reads the rides stored in a snapshot.
+ *
+ * @param fileName Path of the snapshot.
+ * @param rides The vector the rides are appended to, in ride number order.
+ * @return The number of write-ahead log records the rides contain.
+ * @throws std::runtime_error If the file cannot be read, does not start with
+ * a snapshot header or does not hold the number of rides it announces.
+ */
+std::uint64_t readSnapshot(const char *fileName,
+                           std::vector<rideInfo> &rides) {
+  mappedFile file(fileName);
+
+  std::uint64_t count = 0, logPosition = 0;
+  if (file.size() >= snapshotHeaderSize) {
+    std::memcpy(&count, file.begin() + binaryHeaderSize, sizeof(count));
+    std::memcpy(&logPosition, file.begin() + binaryHeaderSize + sizeof(count),
+                sizeof(logPosition));
+  }
+
+  if (file.size() < snapshotHeaderSize ||
+      !checkHeader(snapshotMagic, file.begin()) ||
+      (file.size() - snapshotHeaderSize) / snapshotRecordSize != count ||
+      (file.size() - snapshotHeaderSize) % snapshotRecordSize != 0) {
+    throw std::runtime_error(std::string(fileName) + " is not a snapshot");
+  }
+
+  rides.reserve(rides.size() + count);
+  for (const char *record = file.begin() + snapshotHeaderSize;
+       record < file.end(); record += snapshotRecordSize) {
+    rideInfo ride;
+    decodeRide(record, ride.rideNumber, ride.rideCost, ride.tripDuration);
+    rides.push_back(ride);
+  }
+  return logPosition;
+}
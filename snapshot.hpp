@@ -0,0 +1,39 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "bPlusTree.hpp"
+#include "rbTree.hpp"
+#include "rideStore.hpp"
+#include <cstdint>
+#include <sys/types.h>
+#include <vector>
+
+// Snapshots store the active rides of a tree in ride number order, in the
+// binary format described in binaryFormat.hpp. A snapshot is written to a
+// temporary file next to the target and renamed over it once complete, so a
+// crash never leaves a truncated snapshot behind. A snapshot also records how
+// many write-ahead log records it contains, so that recovery replays only the
+// records that follow it.
+
+// Writes a snapshot of the tree to the given file. Tree is rbTree or
+// bPlusTree.
+// Throws std::runtime_error if the file cannot be written.
+template <typename Tree>
+void writeSnapshot(const Tree &tree, const char *fileName,
+                   std::uint64_t logPosition);
+
+// Forks a child process that writes a snapshot of the tree as it is at the
+// time of the call, while the caller keeps changing its own copy. Returns the
+// process id of the child, which exits with status 0 on success.
+// Throws std::runtime_error if the process cannot be created.
+template <typename Tree>
+pid_t startSnapshot(const Tree &tree, const char *fileName,
+                    std::uint64_t logPosition);
+
+// Reads the rides of a snapshot, in ride number order, and returns the number
+// of write-ahead log records they contain.
+// Throws std::runtime_error if the file cannot be read or is not a snapshot.
+std::uint64_t readSnapshot(const char *fileName,
+                           std::vector<rideInfo> &rides);
+
+#endif // SNAPSHOT_H
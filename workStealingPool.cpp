@@ -0,0 +1,142 @@
+#include "workStealingPool.hpp"
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Constructor for workStealingPool class, starting the workers.
+ *
+ * @param threads The number of worker threads, at least one.
+ */
+workStealingPool::workStealingPool(int threads)
+    : queues(new queue[std::max(threads, 1)]),
+      workerCount(std::max(threads, 1)), queued(0), pending(0), nextQueue(0),
+      stopping(false) {
+  for (int i = 0; i < workerCount; i++) {
+    workers.emplace_back(&workStealingPool::work, this, i);
+  }
+}
+
+/**
+ * @brief Destructor for workStealingPool class. Waits for the submitted tasks,
+ * then wakes the idle workers to let them end.
+ */
+workStealingPool::~workStealingPool() {
+  wait();
+  {
+    std::lock_guard<std::mutex> guard(idleLock);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Returns the number of worker threads.
+ *
+ * @return The number of worker threads.
+ */
+int workStealingPool::getWorkerCount() const {
+  return workerCount;
+}
+
+/**
+ * @brief Submits a task to the pool.
+ *
+ * @details The task is counted as pending before it becomes visible, so wait()
+ * cannot return between a task submitting its continuation and finishing.
+ * The idle lock is taken before waking a worker, so a worker that just found
+ * every deque empty is either already waiting or sees the new task.
+ *
+ * @param newTask The task to run.
+ * @param worker The worker whose deque takes the task, or -1 to take turns.
+ */
+void workStealingPool::submit(task newTask, int worker) {
+  if (worker < 0 || worker >= workerCount) {
+    worker = nextQueue++ % workerCount;
+  }
+
+  pending++;
+  {
+    std::lock_guard<std::mutex> guard(queues[worker].lock);
+    queues[worker].tasks.push_back(std::move(newTask));
+  }
+  queued++;
+
+  { std::lock_guard<std::mutex> guard(idleLock); }
+  workAvailable.notify_one();
+}
+
+/**
+ * @brief Takes the next task of a worker.
+ *
+ * @details The worker's own deque is used as a stack and the others as
+ * queues: the newest own task continues the work just done, while the oldest
+ * task of a victim is the one its owner would get to last. Victims are tried
+ * in order starting after the worker, which spreads thieves over the deques.
+ *
+ * @param worker The index of the worker.
+ * @param next Receives the task.
+ * @return True if a task was taken, false if every deque was empty.
+ */
+bool workStealingPool::take(int worker, task &next) {
+  {
+    queue &own = queues[worker];
+    std::lock_guard<std::mutex> guard(own.lock);
+    if (!own.tasks.empty()) {
+      next = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued--;
+      return true;
+    }
+  }
+
+  for (int i = 1; i < workerCount; i++) {
+    queue &victim = queues[(worker + i) % workerCount];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      next = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued--;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Main loop of a worker, running tasks and sleeping while there are
+ * none.
+ *
+ * @param worker The index of the worker.
+ */
+void workStealingPool::work(int worker) {
+  task next;
+  while (true) {
+    if (take(worker, next)) {
+      next(worker);
+      next = nullptr;
+
+      if (--pending == 0) {
+        std::lock_guard<std::mutex> guard(idleLock);
+        allDone.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> guard(idleLock);
+    workAvailable.wait(guard, [this]() { return queued > 0 || stopping; });
+    if (stopping && queued == 0) {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Waits until all submitted tasks have finished.
+ */
+void workStealingPool::wait() {
+  std::unique_lock<std::mutex> guard(idleLock);
+  allDone.wait(guard, [this]() { return pending == 0; });
+}
@@ -0,0 +1,75 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include "cacheAlignedAllocator.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of worker threads, each with its own deque of tasks. A worker takes
+// the newest task of its own deque, which is the one most likely still in its
+// cache, and when that is empty steals the oldest task of another worker.
+// Tasks receive the index of the worker running them, so a task can submit
+// its continuation to the same worker and keep its data local unless another
+// worker runs out of work.
+class workStealingPool {
+public:
+  // A task, called with the index of the worker running it.
+  using task = std::function<void(int worker)>;
+
+private:
+  // The deque of one worker, on its own cache line so that workers taking
+  // their own tasks do not slow each other down.
+  struct alignas(cacheLineSize) queue {
+    std::mutex lock;
+    std::deque<task> tasks;
+  };
+
+  std::unique_ptr<queue[]> queues;
+  std::vector<std::thread> workers;
+  int workerCount;
+
+  std::atomic<int> queued;         // Tasks waiting in the deques.
+  std::atomic<int> pending;        // Tasks submitted and not yet finished.
+  std::atomic<unsigned> nextQueue; // Deque of the next outside submission.
+  bool stopping;                   // Set under idleLock to end the workers.
+
+  // Idle workers wait on workAvailable, wait() on allDone.
+  std::mutex idleLock;
+  std::condition_variable workAvailable, allDone;
+
+  // Takes a task for the given worker, from its own deque or stolen from
+  // another one, returning false if every deque is empty.
+  bool take(int worker, task &next);
+
+  // Runs tasks until the pool is destroyed.
+  void work(int worker);
+
+public:
+  // Starts the given number of worker threads, at least one.
+  explicit workStealingPool(int threads);
+
+  // Waits for all tasks and stops the workers.
+  ~workStealingPool();
+
+  workStealingPool(const workStealingPool &) = delete;
+  workStealingPool &operator=(const workStealingPool &) = delete;
+
+  // Returns the number of worker threads.
+  int getWorkerCount() const;
+
+  // Adds a task to the deque of the given worker, or spreads tasks over the
+  // workers in turn if worker is -1.
+  void submit(task newTask, int worker = -1);
+
+  // Waits until every submitted task has finished, including the tasks they
+  // submitted themselves.
+  void wait();
+};
+
+#endif // WORKSTEALINGPOOL_H
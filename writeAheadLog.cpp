@@ -0,0 +1,122 @@
+#include "writeAheadLog.hpp"
+#include "binaryFormat.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+/**
+ * @brief Constructor for writeAheadLog class.
+ *
+ * @param fileName Path of the log, which is created if it does not exist.
+ * @param validSize Number of bytes of the existing log to keep.
+ * @param recordCount Number of records in the kept bytes.
+ * @param groupRecords Number of records that complete a group.
+ * @param groupWindow Time after which a group is complete, whatever its size.
+ * @throws std::runtime_error If the file cannot be opened or truncated.
+ */
+writeAheadLog::writeAheadLog(const char *fileName, std::size_t validSize,
+                             std::uint64_t recordCount,
+                             std::size_t groupRecords,
+                             std::chrono::microseconds groupWindow)
+    : pendingRecords(0), groupRecords(groupRecords), groupWindow(groupWindow),
+      recordCount(recordCount) {
+  fd = open(fileName, O_WRONLY | O_CREAT, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("could not open file ") + fileName);
+  }
+
+  // A log that is too short for its header was cut off while it was created.
+  if (validSize < binaryHeaderSize) {
+    validSize = 0;
+    this->recordCount = 0;
+    pending.resize(binaryHeaderSize);
+    encodeHeader(commandLogMagic, pending.data());
+  }
+
+  if (ftruncate(fd, validSize) != 0 || lseek(fd, 0, SEEK_END) < 0) {
+    close(fd);
+    throw std::runtime_error(std::string("could not truncate file ") +
+                             fileName);
+  }
+  pending.reserve(groupRecords * maxCommandRecordSize + binaryHeaderSize);
+}
+
+/**
+ * @brief Destructor for writeAheadLog class.
+ *
+ * @details Commits the pending records and closes the file.
+ */
+writeAheadLog::~writeAheadLog() {
+  try {
+    commit();
+  } catch (const std::exception &) {
+    // A destructor must not throw, the pending records are lost at this point.
+  }
+  close(fd);
+}
+
+/**
+ * @brief Appends a command to the pending group.
+ *
+ * @param cmd The command to log.
+ * @throws std::runtime_error If the group is complete and cannot be committed.
+ */
+void writeAheadLog::append(const command &cmd) {
+  auto now = std::chrono::steady_clock::now();
+  if (pendingRecords == 0) {
+    groupOpen = now;
+  }
+
+  std::size_t size = pending.size();
+  pending.resize(size + maxCommandRecordSize);
+  pending.resize(size + encodeCommand(cmd, pending.data() + size));
+  pendingRecords++;
+  recordCount++;
+
+  if (pendingRecords >= groupRecords || now - groupOpen >= groupWindow) {
+    commit();
+  }
+}
+
+/**
+ * @brief Writes the pending records with a single write and makes them
+ * durable with fdatasync.
+ *
+ * @throws std::runtime_error If the log cannot be written or synced.
+ */
+void writeAheadLog::commit() {
+  if (pending.empty()) {
+    return;
+  }
+
+  std::size_t written = 0;
+  while (written < pending.size()) {
+    ssize_t result =
+        write(fd, pending.data() + written, pending.size() - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("could not write the write-ahead log");
+    }
+    written += result;
+  }
+
+  if (fdatasync(fd) != 0) {
+    throw std::runtime_error("could not sync the write-ahead log");
+  }
+
+  pending.clear();
+  pendingRecords = 0;
+}
+
+/**
+ * @brief Getter for the number of records in the log.
+ *
+ * @return The number of records, committed or not.
+ */
+std::uint64_t writeAheadLog::getRecordCount() const {
+  return recordCount;
+}
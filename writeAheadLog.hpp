@@ -0,0 +1,53 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include "commandParser.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Append-only log of the commands that changed the rides, stored as a binary
+// command log (see binaryFormat.hpp) so that it is replayed like any other
+// command file. Records are collected in memory and committed in groups: a
+// group is written and synced with one write and one fdatasync once it holds
+// groupRecords records or its oldest record has waited groupWindow. Results
+// of logged commands must not be shown before commit() returns.
+class writeAheadLog {
+private:
+  int fd;                                          // Descriptor of the log.
+  std::vector<char> pending;                       // Uncommitted records.
+  std::size_t pendingRecords;                      // Records in pending.
+  std::size_t groupRecords;                        // Largest group.
+  std::chrono::microseconds groupWindow;           // Longest wait of a group.
+  std::chrono::steady_clock::time_point groupOpen; // First pending record.
+  std::uint64_t recordCount;                       // Records in the log.
+
+public:
+  // Opens the log and keeps its first validSize bytes, which hold
+  // recordCount complete records. Anything after them is a record torn by a
+  // crash and is cut off. A validSize too small for the header starts a new
+  // log. Throws std::runtime_error if the file cannot be opened.
+  writeAheadLog(const char *fileName, std::size_t validSize,
+                std::uint64_t recordCount, std::size_t groupRecords,
+                std::chrono::microseconds groupWindow);
+
+  // Commits the pending records and closes the log.
+  ~writeAheadLog();
+
+  writeAheadLog(const writeAheadLog &) = delete;
+  writeAheadLog &operator=(const writeAheadLog &) = delete;
+
+  // Appends a command, committing the group if it is complete.
+  // Throws std::runtime_error if a commit fails.
+  void append(const command &cmd);
+
+  // Writes and syncs the pending records.
+  // Throws std::runtime_error if the log cannot be written.
+  void commit();
+
+  // Returns the number of records in the log, including pending ones.
+  std::uint64_t getRecordCount() const;
+};
+
+#endif // WRITEAHEADLOG_H